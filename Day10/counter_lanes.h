@@ -0,0 +1,172 @@
+#ifndef DAY10_COUNTER_LANES_H
+#define DAY10_COUNTER_LANES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "machine_parser.h"
+
+// Joltage counters held as int16_t lanes, 16 to a 32-byte block: one AVX2
+// register when built with -mavx2, a pair of SSE2 registers otherwise (GCC
+// and clang lower the vector extension to whatever the target has).
+//
+// In memory a state is a plain int16_t array padded to a whole number of
+// blocks; unused lanes stay 0 in the state, the buttons and the target, so
+// they never trip a check. Pressing a button is one add of its incidence row
+// per block, and "some counter went past its target" is one signed compare
+// per block.
+//
+// Blocks are only ever loaded through LaneBlock, which is unaligned and may
+// alias int16_t. Keeping storage as int16_t keeps std::vector off the
+// over-aligned allocation path that a 32-byte-aligned element type takes
+// under -mavx2.
+// Blocks are passed by reference: a 32-byte vector by value has a different
+// ABI with and without AVX, which GCC warns about.
+typedef int16_t LaneBlock __attribute__((vector_size(32), aligned(2), may_alias));
+typedef uint64_t LaneWords __attribute__((vector_size(32), aligned(2), may_alias));
+
+constexpr int kCounterLanes = 16;
+
+inline int counterBlocks(int counters) { return (counters + kCounterLanes - 1) / kCounterLanes; }
+
+inline const LaneBlock& block(const int16_t* p) { return *reinterpret_cast<const LaneBlock*>(p); }
+inline LaneBlock& block(int16_t* p) { return *reinterpret_cast<LaneBlock*>(p); }
+
+inline bool anyLane(const LaneBlock& mask) {
+    LaneWords w = (LaneWords)mask;
+    return (w[0] | w[1] | w[2] | w[3]) != 0;
+}
+
+// The incidence matrix and targets of one machine, padded to whole blocks.
+struct LaneMachine {
+    int counters = 0;
+    int blocks = 0;
+    int num_buttons = 0;
+    int widest_button = 0;         // most counters any one button bumps
+    int max_target = 0;            // largest counter value any state reaches
+    std::vector<int16_t> buttons;  // num_buttons rows of blocks * 16 lanes
+    std::vector<int16_t> target;   // blocks * 16 lanes
+    std::vector<int> press_bound;  // per button, the most presses any solution uses
+
+    int lanes() const { return blocks * kCounterLanes; }
+    const int16_t* button(int j) const { return &buttons[(size_t)j * lanes()]; }
+};
+
+// False if a target does not fit an int16_t lane with room to spare. A lane
+// at its target is one press below INT16_MAX at most, so pressButton's add
+// cannot wrap before the compare catches it.
+inline bool toLanes(const MachineSpec& spec, LaneMachine& out) {
+    out.counters = spec.counters();
+    out.blocks = counterBlocks(out.counters);
+    out.num_buttons = spec.num_buttons();
+    out.widest_button = 0;
+    out.max_target = 0;
+    out.buttons.assign((size_t)out.num_buttons * out.lanes(), 0);
+    out.target.assign(out.lanes(), 0);
+    out.press_bound.assign(out.num_buttons, 0);
+    for (int c = 0; c < out.counters; ++c) {
+        if (spec.targets[c] >= std::numeric_limits<int16_t>::max()) return false;
+        out.target[c] = (int16_t)spec.targets[c];
+        out.max_target = std::max(out.max_target, spec.targets[c]);
+    }
+    for (int j = 0; j < out.num_buttons; ++j) {
+        const uint8_t* row = spec.row(j);
+        int width = 0, bound = std::numeric_limits<int16_t>::max();
+        for (int c = 0; c < out.counters; ++c) {
+            out.buttons[(size_t)j * out.lanes() + c] = row[c];
+            width += row[c];
+            if (row[c]) bound = std::min(bound, (int)out.target[c]);
+        }
+        // Every press raises each counter the button touches, so it can be
+        // pressed at most as often as the smallest of their targets. A
+        // button that touches nothing only adds presses and is never used.
+        out.press_bound[j] = width ? bound : 0;
+        out.widest_button = std::max(out.widest_button, width);
+    }
+    return true;
+}
+
+// " (press bounds a b c ...)", for per-machine reports.
+inline std::string pressBounds(const LaneMachine& machine) {
+    std::string s = " (press bounds";
+    for (int bound : machine.press_bound) s += " " + std::to_string(bound);
+    return s + ")";
+}
+
+// out = state + button; false (with out partly written) if any counter
+// would exceed its target.
+inline bool pressButton(const int16_t* state, const int16_t* button, const int16_t* target, int16_t* out,
+                        int blocks) {
+    for (int b = 0; b < blocks; ++b) {
+        int k = b * kCounterLanes;
+        LaneBlock& next = block(out + k);
+        next = block(state + k) + block(button + k);
+        if (anyLane(next > block(target + k))) return false;
+    }
+    return true;
+}
+
+// out = state - button; false (with out partly written) if any counter
+// would drop below zero.
+inline bool releaseButton(const int16_t* state, const int16_t* button, int16_t* out, int blocks) {
+    for (int b = 0; b < blocks; ++b) {
+        int k = b * kCounterLanes;
+        LaneBlock& next = block(out + k);
+        next = block(state + k) - block(button + k);
+        if (anyLane(next < 0)) return false;
+    }
+    return true;
+}
+
+// Halves every counter in place; the caller makes sure they are all even.
+inline void halveCounters(int16_t* state, int blocks) {
+    for (int k = 0; k < blocks * kCounterLanes; k += kCounterLanes) block(state + k) = block(state + k) >> 1;
+}
+
+inline bool sameCounters(const int16_t* a, const int16_t* b, int blocks) {
+    for (int k = 0; k < blocks * kCounterLanes; k += kCounterLanes)
+        if (anyLane(block(a + k) != block(b + k))) return false;
+    return true;
+}
+
+inline size_t hashCounters(const int16_t* state, int blocks) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    for (int k = 0; k < blocks * kCounterLanes; k += kCounterLanes) {
+        LaneWords w = (LaneWords)block(state + k);
+        for (int i = 0; i < 4; ++i) h = (h ^ w[i]) * 0x100000001B3ULL;
+    }
+    return (size_t)(h ^ (h >> 29));
+}
+
+// Largest and summed gap target - state over all lanes.
+inline void counterGaps(const int16_t* state, const int16_t* target, int blocks, int& max_gap, int& sum_gap) {
+    max_gap = 0;
+    sum_gap = 0;
+    for (int k = 0; k < blocks * kCounterLanes; k += kCounterLanes) {
+        LaneBlock gap = block(target + k) - block(state + k);
+        for (int l = 0; l < kCounterLanes; ++l) {
+            max_gap = std::max(max_gap, (int)gap[l]);
+            sum_gap += gap[l];
+        }
+    }
+}
+
+// Counter state as a hashable value, for the map-based searches. Always
+// blocks * 16 lanes long.
+using LaneState = std::vector<int16_t>;
+
+struct LaneStateHash {
+    size_t operator()(const LaneState& s) const { return hashCounters(s.data(), (int)s.size() / kCounterLanes); }
+};
+
+struct LaneStateEqual {
+    bool operator()(const LaneState& a, const LaneState& b) const {
+        return a.size() == b.size() && sameCounters(a.data(), b.data(), (int)a.size() / kCounterLanes);
+    }
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef DAY10_GF2_SUBSETS_H
+#define DAY10_GF2_SUBSETS_H
+
+#include <cstdint>
+#include <vector>
+
+// Visits the XOR of every subset of masks[begin, end) in Gray-code order, so
+// each step is a single XOR: visit(xor, popcount, subset), where bit i of
+// subset stands for masks[begin + i] and consecutive subsets differ in
+// exactly one bit.
+template <typename Visit>
+void forEachSubset(const std::vector<uint64_t>& masks, int begin, int end, const Visit& visit) {
+    int k = end - begin;
+    uint64_t x = 0;
+    int pressed = 0;
+    visit(x, 0, (uint64_t)0);
+    for (uint64_t g = 1; g < (1ULL << k); ++g) {
+        int bit = __builtin_ctzll(g);
+        bool on = (g ^ (g >> 1)) >> bit & 1;
+        x ^= masks[begin + bit];
+        pressed += on ? 1 : -1;
+        visit(x, pressed, g ^ (g >> 1));
+    }
+}
+
+#endif
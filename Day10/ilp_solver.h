@@ -0,0 +1,319 @@
+#ifndef DAY10_ILP_SOLVER_H
+#define DAY10_ILP_SOLVER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+// Exact solver for Day10 part 2: min sum(x) subject to A x = b, x >= 0
+// integer, where A[c][j] = 1 when button j bumps counter c.
+//
+// Gaussian elimination over the rationals brings A to reduced row echelon
+// form, which writes every pivot button as an affine function of the free
+// buttons. Only the free buttons (usually 0-3 of them) are then searched,
+// by depth-first branch and bound: at each node the row constraints
+// 0 <= pivot <= bound are propagated into the free variables' intervals,
+// and the objective's minimum over the resulting box bounds the node.
+//
+// That bound is a box relaxation, not the LP relaxation of A x = b, x >= 0:
+// it ignores the rows once they have been propagated into the intervals.
+// With so few free variables propagation already keeps the tree small (a
+// few thousand nodes for the whole input), so no simplex is run.
+
+// Exact rational with long long parts. Every operation is carried out in
+// __int128 and reduced before it is stored, so nothing wraps silently: a
+// result whose reduced parts still do not fit sets overflow, which sticks to
+// everything computed from it.
+struct Rational {
+    long long num = 0, den = 1;
+    bool overflow = false;
+
+    Rational() = default;
+    Rational(long long n, long long d = 1) { assign(n, d); }
+
+    bool isZero() const { return num == 0; }
+
+    friend Rational operator+(Rational a, Rational b) {
+        return from(a, b, (__int128)a.num * b.den + (__int128)b.num * a.den, (__int128)a.den * b.den);
+    }
+    friend Rational operator-(Rational a, Rational b) {
+        return from(a, b, (__int128)a.num * b.den - (__int128)b.num * a.den, (__int128)a.den * b.den);
+    }
+    friend Rational operator*(Rational a, Rational b) {
+        return from(a, b, (__int128)a.num * b.num, (__int128)a.den * b.den);
+    }
+    friend Rational operator/(Rational a, Rational b) {
+        return from(a, b, (__int128)a.num * b.den, (__int128)a.den * b.num);
+    }
+    friend bool operator<(Rational a, Rational b) { return (__int128)a.num * b.den < (__int128)b.num * a.den; }
+
+private:
+    static Rational from(const Rational& a, const Rational& b, __int128 n, __int128 d) {
+        Rational r;
+        r.assign(n, d);
+        r.overflow |= a.overflow || b.overflow;
+        return r;
+    }
+
+    void assign(__int128 n, __int128 d) {
+        if (d < 0) n = -n, d = -d;
+        __int128 x = n < 0 ? -n : n, y = d;
+        while (y != 0) {
+            __int128 t = x % y;
+            x = y;
+            y = t;
+        }
+        if (x > 1) n /= x, d /= x;
+        const __int128 lo = std::numeric_limits<long long>::min(), hi = std::numeric_limits<long long>::max();
+        if (d == 0 || n < lo || n > hi || d > hi) {
+            overflow = true;
+            num = 0, den = 1;
+            return;
+        }
+        num = (long long)n, den = (long long)d;
+    }
+};
+
+// floor(a / b) and ceil(a / b) for b > 0.
+inline long long floorDiv(long long a, long long b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+inline long long ceilDiv(long long a, long long b) { return a >= 0 ? (a + b - 1) / b : -((-a) / b); }
+
+struct IlpStats {
+    int rank = 0;
+    int free_vars = 0;
+    long long nodes = 0;
+};
+
+class IlpSolver {
+public:
+    // Returned when the elimination or the integer rows outgrow 64 bits; the
+    // machine is then left unsolved rather than answered wrongly.
+    static constexpr long long kOverflow = -2;
+
+    // buttons[j] lists the counters button j bumps; targets[c] is counter c's
+    // goal. Returns the fewest presses, -1 when no press vector exists, or
+    // kOverflow.
+    static long long solve(const std::vector<std::vector<int>>& buttons, const std::vector<int>& targets,
+                           IlpStats* stats = nullptr) {
+        IlpSolver s(buttons, targets);
+        long long best = s.run();
+        if (stats) *stats = s.stats_;
+        return best;
+    }
+
+private:
+    // One reduced row: den * x[pivot] + sum coef[f] * x[free[f]] = rhs.
+    struct Row {
+        int pivot;
+        long long den, rhs;
+        std::vector<long long> coef;
+    };
+
+    int n_, m_;
+    std::vector<std::vector<Rational>> a_;  // n x (m + 1), augmented
+    std::vector<long long> upper_;          // per-button press bound
+    std::vector<int> free_;                 // free button indices
+    std::vector<Row> rows_;
+    std::vector<Rational> weight_;          // objective coefficient per free var
+    Rational constant_;                     // objective at all free vars = 0
+    long long best_ = std::numeric_limits<long long>::max();
+    bool overflow_ = false;
+    IlpStats stats_;
+
+    IlpSolver(const std::vector<std::vector<int>>& buttons, const std::vector<int>& targets)
+        : n_((int)targets.size()), m_((int)buttons.size()), a_(n_, std::vector<Rational>(m_ + 1)),
+          upper_(m_, 0) {
+        for (int j = 0; j < m_; ++j) {
+            long long bound = -1;
+            for (int c : buttons[j]) {
+                if (c < 0 || c >= n_) continue;
+                a_[c][j] = Rational(1);
+                bound = bound < 0 ? targets[c] : std::min<long long>(bound, targets[c]);
+            }
+            // A button that touches nothing never helps.
+            upper_[j] = std::max(bound, 0LL);
+        }
+        for (int c = 0; c < n_; ++c) a_[c][m_] = Rational(targets[c]);
+    }
+
+    // Reduced row echelon form; false if some row reads 0 = nonzero, or
+    // (with overflow_ set) if an entry outgrew 64 bits.
+    bool eliminate(std::vector<int>& pivots) {
+        int r = 0;
+        for (int col = 0; col < m_ && r < n_; ++col) {
+            int sel = -1;
+            for (int i = r; i < n_; ++i)
+                if (!a_[i][col].isZero()) {
+                    sel = i;
+                    break;
+                }
+            if (sel < 0) continue;
+            std::swap(a_[r], a_[sel]);
+            Rational inv = Rational(1) / a_[r][col];
+            for (int k = col; k <= m_; ++k) {
+                a_[r][k] = a_[r][k] * inv;
+                if (a_[r][k].overflow) {
+                    overflow_ = true;
+                    return false;
+                }
+            }
+            for (int i = 0; i < n_; ++i) {
+                if (i == r || a_[i][col].isZero()) continue;
+                Rational f = a_[i][col];
+                for (int k = col; k <= m_; ++k) {
+                    a_[i][k] = a_[i][k] - f * a_[r][k];
+                    if (a_[i][k].overflow) {
+                    overflow_ = true;
+                    return false;
+                }
+                }
+            }
+            pivots.push_back(col);
+            ++r;
+        }
+        for (int i = r; i < n_; ++i)
+            if (!a_[i][m_].isZero()) return false;
+        return true;
+    }
+
+    long long run() {
+        std::vector<int> pivots;
+        if (!eliminate(pivots)) return overflow_ ? kOverflow : -1;
+
+        std::vector<bool> is_pivot(m_, false);
+        for (int p : pivots) is_pivot[p] = true;
+        for (int j = 0; j < m_; ++j)
+            if (!is_pivot[j]) free_.push_back(j);
+        stats_.rank = (int)pivots.size();
+        stats_.free_vars = (int)free_.size();
+
+        // Clear denominators so the search runs on integers only. Each row
+        // must keep |rhs|, den * upper and sum |coef| * upper below 2^62, so
+        // the sums in propagate and evaluate cannot wrap either.
+        weight_.assign(free_.size(), Rational(1));
+        constant_ = Rational(0);
+        const __int128 limit = (__int128)1 << 62;
+        for (size_t i = 0; i < pivots.size(); ++i) {
+            const std::vector<Rational>& src = a_[i];
+            __int128 l = src[m_].den;
+            for (int f : free_) {
+                l = l / std::gcd((long long)(l % src[f].den), src[f].den) * src[f].den;
+                if (l >= limit) return kOverflow;
+            }
+            __int128 rhs = src[m_].num * (l / src[m_].den);
+            __int128 span = l * upper_[pivots[i]] + (rhs < 0 ? -rhs : rhs);
+            Row row{pivots[i], (long long)l, (long long)rhs, {}};
+            for (size_t k = 0; k < free_.size(); ++k) {
+                const Rational& c = src[free_[k]];
+                __int128 coef = c.num * (l / c.den);
+                span += (coef < 0 ? -coef : coef) * upper_[free_[k]];
+                if (span >= limit) return kOverflow;
+                row.coef.push_back((long long)coef);
+                weight_[k] = weight_[k] - c;
+            }
+            if (span >= limit) return kOverflow;
+            constant_ = constant_ + src[m_];
+            rows_.push_back(row);
+        }
+        for (const Rational& w : weight_)
+            if (w.overflow) return kOverflow;
+        if (constant_.overflow) return kOverflow;
+
+        std::vector<long long> lo(free_.size(), 0), hi(free_.size());
+        for (size_t k = 0; k < free_.size(); ++k) hi[k] = upper_[free_[k]];
+        search(lo, hi);
+        return best_ == std::numeric_limits<long long>::max() ? -1 : best_;
+    }
+
+    // Tightens [lo, hi] until every row can still land its pivot in
+    // [0, upper]. False if some interval empties.
+    bool propagate(std::vector<long long>& lo, std::vector<long long>& hi) const {
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (const Row& row : rows_) {
+                // rhs - den * upper <= sum coef * x <= rhs
+                long long need_lo = row.rhs - row.den * upper_[row.pivot];
+                long long need_hi = row.rhs;
+                long long smin = 0, smax = 0;
+                for (size_t k = 0; k < row.coef.size(); ++k) {
+                    long long c = row.coef[k];
+                    smin += c > 0 ? c * lo[k] : c * hi[k];
+                    smax += c > 0 ? c * hi[k] : c * lo[k];
+                }
+                if (smax < need_lo || smin > need_hi) return false;
+                for (size_t k = 0; k < row.coef.size(); ++k) {
+                    long long c = row.coef[k];
+                    if (c == 0 || lo[k] == hi[k]) continue;
+                    // Range of c * x[k] left once the others take their extremes.
+                    long long rest_min = smin - (c > 0 ? c * lo[k] : c * hi[k]);
+                    long long rest_max = smax - (c > 0 ? c * hi[k] : c * lo[k]);
+                    long long t_lo = need_lo - rest_max, t_hi = need_hi - rest_min;
+                    long long nlo = c > 0 ? ceilDiv(t_lo, c) : ceilDiv(-t_hi, -c);
+                    long long nhi = c > 0 ? floorDiv(t_hi, c) : floorDiv(-t_lo, -c);
+                    if (nlo > lo[k] || nhi < hi[k]) {
+                        lo[k] = std::max(lo[k], nlo);
+                        hi[k] = std::min(hi[k], nhi);
+                        if (lo[k] > hi[k]) return false;
+                        changed = true;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // Box bound: every free variable at whichever end of its interval its
+    // objective weight prefers.
+    Rational lowerBound(const std::vector<long long>& lo, const std::vector<long long>& hi) const {
+        Rational z = constant_;
+        for (size_t k = 0; k < free_.size(); ++k) z = z + weight_[k] * Rational(weight_[k].num < 0 ? hi[k] : lo[k]);
+        return z;
+    }
+
+    // Every free variable fixed: the pivots must come out integral and in range.
+    void evaluate(const std::vector<long long>& x) {
+        long long total = 0;
+        for (long long v : x) total += v;
+        for (const Row& row : rows_) {
+            long long s = row.rhs;
+            for (size_t k = 0; k < row.coef.size(); ++k) s -= row.coef[k] * x[k];
+            if (s % row.den != 0) return;
+            long long p = s / row.den;
+            if (p < 0 || p > upper_[row.pivot]) return;
+            total += p;
+        }
+        best_ = std::min(best_, total);
+    }
+
+    void search(std::vector<long long> lo, std::vector<long long> hi) {
+        ++stats_.nodes;
+        if (!propagate(lo, hi)) return;
+        // Objective values are integers, so a bound above best - 1 cannot improve.
+        // A bound that overflowed proves nothing, so the node is kept.
+        if (best_ != std::numeric_limits<long long>::max()) {
+            Rational lb = lowerBound(lo, hi);
+            if (!lb.overflow && ceilDiv(lb.num, lb.den) >= best_) return;
+        }
+
+        int branch = -1;
+        for (size_t k = 0; k < free_.size(); ++k)
+            if (lo[k] < hi[k] && (branch < 0 || hi[k] - lo[k] < hi[branch] - lo[branch])) branch = (int)k;
+        if (branch < 0) {
+            evaluate(lo);
+            return;
+        }
+
+        // Walk the branch variable from its cheap end so good answers come early.
+        bool up = weight_[branch].num >= 0;
+        for (long long v = up ? lo[branch] : hi[branch]; up ? v <= hi[branch] : v >= lo[branch]; up ? ++v : --v) {
+            std::vector<long long> clo = lo, chi = hi;
+            clo[branch] = chi[branch] = v;
+            search(clo, chi);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,185 @@
+#ifndef DAY10_MACHINE_PARSER_H
+#define DAY10_MACHINE_PARSER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// One machine line, "[.##.] (3) (1,3) (2) {3,5,4,7}", in flat arrays.
+//
+// Button j's counter indices are button_counters[button_start[j] ..
+// button_start[j + 1]); the same buttons as a dense num_buttons x counters()
+// 0/1 incidence matrix are in `incidence`. Indices at or past counters() are
+// kept in the index lists and light masks but left out of the matrix, which
+// is what the part 2 solvers have always done with them.
+struct MachineSpec {
+    int num_lights = 0;
+    uint64_t lights = 0;                 // bit i set when light i is '#' (first 64 lights)
+    std::vector<uint64_t> masks;         // per button, the lights it toggles (first 64)
+    std::vector<int> button_start;       // num_buttons() + 1 offsets
+    std::vector<int> button_counters;
+    std::vector<uint8_t> incidence;      // row-major, num_buttons() x counters()
+    std::vector<int> targets;
+
+    int num_buttons() const { return (int)button_start.size() - 1; }
+    int counters() const { return (int)targets.size(); }
+    const uint8_t* row(int button) const { return &incidence[(size_t)button * targets.size()]; }
+
+    // Buttons as separate index lists, for solvers that take that form.
+    std::vector<std::vector<int>> buttonLists() const {
+        std::vector<std::vector<int>> lists(num_buttons());
+        for (int j = 0; j < num_buttons(); ++j)
+            lists[j].assign(button_counters.begin() + button_start[j], button_counters.begin() + button_start[j + 1]);
+        return lists;
+    }
+};
+
+struct ParseStats {
+    size_t bytes = 0;
+    size_t lines = 0;
+    size_t invalid = 0;
+    double ms = 0;
+
+    double linesPerSecond() const { return ms > 0 ? lines / (ms / 1000.0) : 0; }
+};
+
+// Parses one line in a single left-to-right pass into `out`, reusing its
+// storage. The diagram is optional, buttons may be empty "()", and blanks
+// may separate any two tokens. False on anything else.
+inline bool parseMachineLine(const char* p, const char* end, MachineSpec& out) {
+    out.num_lights = 0;
+    out.lights = 0;
+    out.masks.clear();
+    out.button_start.assign(1, 0);
+    out.button_counters.clear();
+    out.incidence.clear();
+    out.targets.clear();
+
+    auto skipBlanks = [&]() {
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    };
+    // "a,b,c" up to `close`; digits only, at most nine per number.
+    auto parseList = [&](char close, std::vector<int>& values) {
+        if (p < end && *p == close) return ++p, true;
+        while (true) {
+            const char* digits = p;
+            int v = 0;
+            while (p < end && (unsigned)(*p - '0') < 10 && p - digits < 9) v = v * 10 + (*p++ - '0');
+            if (p == digits || p == end) return false;
+            values.push_back(v);
+            if (*p == close) return ++p, true;
+            if (*p++ != ',') return false;
+        }
+    };
+
+    skipBlanks();
+    if (p < end && *p == '[') {
+        for (++p; p < end && *p != ']'; ++p) {
+            if (*p != '.' && *p != '#') return false;
+            if (*p == '#' && out.num_lights < 64) out.lights |= 1ULL << out.num_lights;
+            out.num_lights++;
+        }
+        if (p == end) return false;
+        ++p;
+        skipBlanks();
+    }
+    while (p < end && *p == '(') {
+        ++p;
+        size_t first = out.button_counters.size();
+        if (!parseList(')', out.button_counters)) return false;
+        uint64_t mask = 0;
+        for (size_t k = first; k < out.button_counters.size(); ++k)
+            if (out.button_counters[k] < 64) mask ^= 1ULL << out.button_counters[k];
+        out.masks.push_back(mask);
+        out.button_start.push_back((int)out.button_counters.size());
+        skipBlanks();
+    }
+    if (p == end || *p != '{') return false;
+    ++p;
+    if (!parseList('}', out.targets)) return false;
+    skipBlanks();
+    if (p != end) return false;
+
+    size_t width = out.targets.size();
+    out.incidence.assign((size_t)out.num_buttons() * width, 0);
+    for (int j = 0; j < out.num_buttons(); ++j)
+        for (int k = out.button_start[j]; k < out.button_start[j + 1]; ++k)
+            if ((size_t)out.button_counters[k] < width) out.incidence[j * width + out.button_counters[k]] = 1;
+    return true;
+}
+
+// Maps `filename` and parses every non-empty line into `out`. Malformed
+// lines are reported as "Invalid line: ..." on stderr and skipped. Returns
+// false if the file cannot be opened or mapped.
+inline bool parseMachineFile(const std::string& filename, std::vector<MachineSpec>& out,
+                             ParseStats* stats = nullptr) {
+    auto start = std::chrono::steady_clock::now();
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        std::cerr << "Error opening file: " << filename << std::endl;
+        if (fd >= 0) close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    const char* data = nullptr;
+    if (size > 0) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Error: Could not map " << filename << std::endl;
+            close(fd);
+            return false;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+    }
+    close(fd);
+
+    out.clear();
+    size_t lines = 0, invalid = 0;
+    const char* end = data + size;
+    MachineSpec spec;
+    for (const char* p = data; p < end;) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* line_end = nl ? nl : end;
+        const char* content_end = line_end;
+        if (content_end > p && content_end[-1] == '\r') --content_end;
+        if (content_end > p) {
+            lines++;
+            if (parseMachineLine(p, content_end, spec)) {
+                out.push_back(spec);
+            } else {
+                std::cerr << "Invalid line: " << std::string(p, content_end) << std::endl;
+                invalid++;
+            }
+        }
+        p = nl ? nl + 1 : end;
+    }
+
+    if (size > 0) munmap(const_cast<char*>(data), size);
+    if (stats) {
+        stats->bytes = size;
+        stats->lines = lines;
+        stats->invalid = invalid;
+        stats->ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return true;
+}
+
+// One-line throughput summary for stderr.
+inline void reportParse(const ParseStats& stats, size_t machines) {
+    std::cerr << "Parsed " << machines << " machines (" << stats.bytes << " bytes) in " << stats.ms << " ms, "
+              << stats.linesPerSecond() / 1e6 << "M lines/s";
+    if (stats.invalid) std::cerr << ", " << stats.invalid << " invalid lines";
+    std::cerr << std::endl;
+}
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef DAY10_MACHINE_SCHEDULER_H
+#define DAY10_MACHINE_SCHEDULER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Machines are independent but their solve times differ by orders of
+// magnitude, so every Day10 main parses the whole input first and hands the
+// machines to runMachines with a cost estimate each.
+
+// Part 2 size estimate: counters x buttons x largest target.
+inline double part2Cost(const std::vector<std::vector<int>>& buttons, const std::vector<int>& targets) {
+    int max_target = targets.empty() ? 0 : *std::max_element(targets.begin(), targets.end());
+    return (double)targets.size() * buttons.size() * (max_target + 1);
+}
+
+inline int defaultThreads() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw == 0 ? 1 : (int)hw;
+}
+
+// Workers runMachines actually starts: never more than there are machines.
+inline int workerCount(int threads, size_t machines) {
+    return std::max(1, std::min(threads, (int)machines));
+}
+
+// Runs solve(i) for every machine on workerCount(threads) workers and returns each
+// machine's wall time in microseconds. Machines are sorted by descending
+// cost and dealt round-robin, so every worker starts on the most expensive
+// machines; a worker that runs dry steals the most expensive machine left
+// in another queue. solve must write its result to a per-machine slot, so
+// the caller can aggregate in input order regardless of scheduling.
+template <typename Solve>
+std::vector<double> runMachines(const std::vector<double>& cost, int threads, const Solve& solve) {
+    int n = (int)cost.size();
+    threads = workerCount(threads, n);
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return cost[a] > cost[b]; });
+
+    struct Queue {
+        std::mutex mu;
+        std::deque<int> machines;
+    };
+    std::vector<Queue> queues(threads);
+    for (int k = 0; k < n; ++k) queues[k % threads].machines.push_back(order[k]);
+
+    std::vector<double> us(n, 0);
+    auto take = [](Queue& q) {
+        std::lock_guard<std::mutex> lock(q.mu);
+        if (q.machines.empty()) return -1;
+        int i = q.machines.front();
+        q.machines.pop_front();
+        return i;
+    };
+    auto worker = [&](int self) {
+        while (true) {
+            int i = take(queues[self]);
+            for (int k = 1; i < 0 && k < threads; ++k) i = take(queues[(self + k) % threads]);
+            // Solving never adds machines, so empty everywhere means done.
+            if (i < 0) break;
+            auto start = std::chrono::steady_clock::now();
+            solve(i);
+            us[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < threads; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (std::thread& th : pool) th.join();
+    return us;
+}
+
+// Power-of-two histogram of per-machine wall times, then the slowest few
+// machines (1-based, in input order) so pathological ones can be pulled out.
+inline void printTimeHistogram(std::ostream& out, const std::vector<double>& us, int slowest = 5) {
+    if (us.empty()) return;
+    std::vector<int> buckets;
+    for (double t : us) {
+        int b = 0;
+        while (b < 40 && t >= (double)(1ULL << b)) ++b;
+        if ((int)buckets.size() <= b) buckets.resize(b + 1, 0);
+        buckets[b]++;
+    }
+    int peak = *std::max_element(buckets.begin(), buckets.end());
+    out << "Per-machine wall time:\n";
+    char line[64];
+    size_t first = 0;
+    while (buckets[first] == 0) ++first;
+    for (size_t b = first; b < buckets.size(); ++b) {
+        unsigned long long lo = b == 0 ? 0 : 1ULL << (b - 1), hi = 1ULL << b;
+        std::snprintf(line, sizeof(line), "  [%9llu, %9llu) us %6d ", lo, hi, buckets[b]);
+        out << line << std::string(buckets[b] == 0 ? 0 : 1 + buckets[b] * 39 / peak, '#') << "\n";
+    }
+
+    std::vector<int> order(us.size());
+    std::iota(order.begin(), order.end(), 0);
+    int k = std::min<int>(slowest, (int)us.size());
+    std::partial_sort(order.begin(), order.begin() + k, order.end(), [&](int a, int b) { return us[a] > us[b]; });
+    out << "Slowest machines:";
+    for (int i = 0; i < k; ++i) out << " #" << order[i] + 1 << " (" << us[order[i]] << " us)";
+    out << "\n";
+}
+
+#endif
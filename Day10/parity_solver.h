@@ -0,0 +1,91 @@
+#ifndef DAY10_PARITY_SOLVER_H
+#define DAY10_PARITY_SOLVER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "counter_lanes.h"
+#include "gf2_subsets.h"
+
+// Any solution x splits as x = s + 2y, where s (0/1 per button) marks the
+// buttons pressed an odd number of times. A s must match the target's
+// parity on every counter, which is the part 1 lights problem with counters
+// as lights, and y then solves the same problem for (target - A s) / 2:
+//
+//   f(0) = 0,  f(t) = min over such s with A s <= t of |s| + 2 f((t - A s) / 2)
+//
+// Every level halves the target, so the recursion is about log2(max target)
+// deep whatever the magnitudes, and the remainders it reaches are memoized.
+// The 2^buttons subsets are enumerated once, in Gray-code order, and
+// grouped by the parity pattern they produce.
+class ParitySolver {
+public:
+    static constexpr int kMaxButtons = 20;
+
+    explicit ParitySolver(const LaneMachine& machine) : machine_(machine) {
+        int lanes = machine.lanes();
+        std::vector<uint64_t> masks(machine.num_buttons, 0);
+        for (int j = 0; j < machine.num_buttons; j++)
+            for (int c = 0; c < machine.counters; c++)
+                if (machine.button(j)[c]) masks[j] |= 1ULL << c;
+
+        // Consecutive Gray-code subsets differ in one button, so each
+        // effect is the previous one plus or minus a single row
+        std::vector<int16_t> effect(lanes, 0);
+        uint64_t previous = 0;
+        forEachSubset(masks, 0, machine.num_buttons, [&](uint64_t parity, int pressed, uint64_t subset) {
+            if (uint64_t changed = subset ^ previous) {
+                int j = __builtin_ctzll(changed);
+                const int16_t* row = machine.button(j);
+                for (int c = 0; c < machine.counters; c++) effect[c] += subset & changed ? row[c] : -row[c];
+            }
+            previous = subset;
+            by_parity_[parity].push_back((uint32_t)presses_.size());
+            presses_.push_back(pressed);
+            effects_.insert(effects_.end(), effect.begin(), effect.end());
+        });
+    }
+
+    // Fewest presses reaching the target, or -1 if none does
+    long long solve() { return minPresses(machine_.target); }
+
+    size_t memoEntries() const { return memo_.size(); }
+
+private:
+    const LaneMachine& machine_;
+    std::vector<int16_t> effects_;  // per subset, A s padded to lanes()
+    std::vector<int> presses_;      // per subset, |s|
+    std::unordered_map<uint64_t, std::vector<uint32_t>> by_parity_;
+    std::unordered_map<LaneState, long long, LaneStateHash, LaneStateEqual> memo_;
+
+    long long minPresses(const LaneState& target) {
+        uint64_t parity = 0;
+        bool zero = true;
+        for (int c = 0; c < machine_.counters; c++) {
+            parity |= (uint64_t)(target[c] & 1) << c;
+            zero = zero && target[c] == 0;
+        }
+        if (zero) return 0;
+        auto it = memo_.find(target);
+        if (it != memo_.end()) return it->second;
+
+        long long best = -1;
+        auto group = by_parity_.find(parity);
+        if (group != by_parity_.end()) {
+            LaneState rest(target.size());
+            for (uint32_t s : group->second) {
+                if (best >= 0 && presses_[s] >= best) continue;
+                const int16_t* effect = &effects_[(size_t)s * machine_.lanes()];
+                if (!releaseButton(target.data(), effect, rest.data(), machine_.blocks)) continue;
+                halveCounters(rest.data(), machine_.blocks);
+                long long half = minPresses(rest);
+                if (half >= 0 && (best < 0 || presses_[s] + 2 * half < best)) best = presses_[s] + 2 * half;
+            }
+        }
+        memo_.emplace(target, best);
+        return best;
+    }
+};
+
+#endif
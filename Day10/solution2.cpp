@@ -1,127 +1,271 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
-#include <queue>
-#include <map>
 #include <string>
-#include <cctype>
+#include <cstdint>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <random>
+
+#include "gf2_subsets.h"
+#include "machine_parser.h"
+#include "machine_scheduler.h"
 
 using namespace std;
 
-// Machine structure
+// Machine structure. Lights are packed into one word: bit i is light i, and
+// every button is the XOR mask of the lights it toggles.
 struct Machine {
-    vector<vector<int>> buttons;
-    vector<int> target;
+    int num_lights = 0;
+    uint64_t lights = 0;
+    vector<uint64_t> masks;
 };
 
-// Parse a line like "(1,3)" into vector<int>
-vector<int> parseButton(const string &s) {
-    vector<int> res;
-    string tmp;
-    for (char c : s) {
-        if (isdigit(c)) tmp += c;
-        else if (!tmp.empty()) {
-            res.push_back(stoi(tmp));
-            tmp.clear();
-        }
+// Visited set over all 2^bits states, one bit each.
+struct FlatBitmap {
+    vector<uint64_t> words;
+
+    explicit FlatBitmap(int bits) : words(((1ULL << bits) + 63) / 64, 0) {}
+
+    // Marks s; false if it was already marked.
+    bool insert(uint64_t s) {
+        uint64_t bit = 1ULL << (s & 63);
+        uint64_t &w = words[s >> 6];
+        if (w & bit) return false;
+        w |= bit;
+        return true;
     }
-    if (!tmp.empty()) res.push_back(stoi(tmp));
-    return res;
-}
+};
+
+// Open-addressing visited set for wide machines, where 2^bits is too big.
+// Grows at half load; state ~0 is never reached by a machine under 64 lights
+// and is used as the empty slot.
+struct OpenAddressSet {
+    static constexpr uint64_t EMPTY = ~0ULL;
+    vector<uint64_t> slots;
+    size_t count = 0;
 
-// Parse a line like "{3,5,4,7}" into vector<int>
-vector<int> parseTarget(const string &s) {
-    vector<int> res;
-    string tmp;
-    for (char c : s) {
-        if (isdigit(c)) tmp += c;
-        else if (!tmp.empty()) {
-            res.push_back(stoi(tmp));
-            tmp.clear();
+    explicit OpenAddressSet(int) : slots(1024, EMPTY) {}
+
+    static size_t hash(uint64_t s) { return (size_t)((s * 0x9E3779B97F4A7C15ULL) >> 20); }
+
+    bool insert(uint64_t s) {
+        if (2 * (count + 1) > slots.size()) grow();
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash(s) & mask;; i = (i + 1) & mask) {
+            if (slots[i] == s) return false;
+            if (slots[i] == EMPTY) {
+                slots[i] = s;
+                count++;
+                return true;
+            }
         }
     }
-    if (!tmp.empty()) res.push_back(stoi(tmp));
-    return res;
-}
 
-// BFS to find minimal button presses for one machine
+    void grow() {
+        vector<uint64_t> old(2 * slots.size(), EMPTY);
+        old.swap(slots);
+        count = 0;
+        for (uint64_t s : old)
+            if (s != EMPTY) insert(s);
+    }
+};
+
+// BFS over packed light states: a neighbor is one XOR, the frontier is a flat
+// vector per level, and StateSet is the visited structure.
+template <typename StateSet>
 int minPresses(const Machine &m) {
-    int n = m.target.size();
-    queue<pair<vector<int>, int>> q;
-    map<vector<int>, int> dist;
-
-    vector<int> start(n, 0);
-    q.push({start, 0});
-    dist[start] = 0;
-
-    while (!q.empty()) {
-        auto curr_pair = q.front(); q.pop();
-        vector<int> curr = curr_pair.first;
-        int presses = curr_pair.second;
-
-        if (curr == m.target) return presses;
-
-        for (auto &btn : m.buttons) {
-            vector<int> next = curr;
-            for (int idx : btn) next[idx]++;
-            if (dist.find(next) == dist.end() || dist[next] > presses + 1) {
-                dist[next] = presses + 1;
-                q.push({next, presses + 1});
+    if (m.lights == 0) return 0;
+    StateSet visited(m.num_lights);
+    visited.insert(0);
+    vector<uint64_t> frontier = {0}, next;
+
+    for (int presses = 1; !frontier.empty(); ++presses) {
+        next.clear();
+        for (uint64_t s : frontier) {
+            for (uint64_t btn : m.masks) {
+                uint64_t t = s ^ btn;
+                if (t == m.lights) return presses;
+                if (visited.insert(t)) next.push_back(t);
             }
         }
+        frontier.swap(next);
     }
 
     return -1; // unreachable
 }
 
-int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        cerr << "Usage: " << argv[0] << " input.txt\n";
-        return 1;
+int minPressesBfs(const Machine &m) {
+    return m.num_lights <= 24 ? minPresses<FlatBitmap>(m) : minPresses<OpenAddressSet>(m);
+}
+
+// Fewest presses per XOR value over all subsets of one half of the buttons,
+// in an open-addressing table sized for every subset up front.
+struct XorTable {
+    static constexpr uint64_t EMPTY = ~0ULL;
+    vector<uint64_t> keys;
+    vector<uint8_t> presses;
+    size_t mask;
+
+    explicit XorTable(size_t entries) {
+        size_t cap = 16;
+        while (cap < 2 * entries) cap *= 2;
+        keys.assign(cap, EMPTY);
+        presses.assign(cap, 0);
+        mask = cap - 1;
     }
 
-    ifstream fin(argv[1]);
-    if (!fin) {
-        cerr << "Cannot open file: " << argv[1] << "\n";
-        return 1;
+    static size_t hash(uint64_t s) { return (size_t)((s * 0x9E3779B97F4A7C15ULL) >> 17); }
+
+    void keepMin(uint64_t key, uint8_t p) {
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            if (keys[i] == EMPTY) {
+                keys[i] = key;
+                presses[i] = p;
+                return;
+            }
+            if (keys[i] == key) {
+                if (p < presses[i]) presses[i] = p;
+                return;
+            }
+        }
     }
 
-    string line;
-    vector<Machine> machines;
-    while (getline(fin, line)) {
-        if (line.empty()) continue;
+    int find(uint64_t key) const {
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            if (keys[i] == key) return presses[i];
+            if (keys[i] == EMPTY) return -1;
+        }
+    }
+};
 
-        Machine m;
-        stringstream ss(line);
-        string token;
-        vector<string> tokens;
+// Meet in the middle: tabulate the first half of the buttons by XOR result,
+// then for every subset of the second half look up the partner that
+// completes the target. O(2^(b/2)) time and memory for b buttons.
+int minPressesMitm(const Machine &m) {
+    int b = m.masks.size();
+    int half = b / 2;
+    XorTable table(1ULL << half);
+    forEachSubset(m.masks, 0, half, [&](uint64_t x, int p, uint64_t) { table.keepMin(x, p); });
 
-        // Split line by spaces
-        while (ss >> token) tokens.push_back(token);
+    int best = -1;
+    forEachSubset(m.masks, half, b, [&](uint64_t x, int p, uint64_t) {
+        int q = table.find(x ^ m.lights);
+        if (q >= 0 && (best < 0 || p + q < best)) best = p + q;
+    });
+    return best;
+}
 
-        if (tokens.size() < 2) continue;
+// BFS touches at most min(2^lights, 2^buttons) states with one XOR per
+// button each; meet in the middle always pays about 2^(buttons/2) table
+// operations.
+double bfsCost(const Machine &m) {
+    int b = m.masks.size();
+    return ldexp((double)b, min(m.num_lights, b));
+}
 
-        // Last token is target counters
-        m.target = parseTarget(tokens.back());
+double mitmCost(const Machine &m) { return ldexp(8.0, ((int)m.masks.size() + 1) / 2); }
+
+// Pick the cheaper estimate.
+int minPresses(const Machine &m) {
+    return bfsCost(m) <= mitmCost(m) ? minPressesBfs(m) : minPressesMitm(m);
+}
 
-        // All other tokens (except first machine diagram) are buttons
-        for (size_t i = 1; i + 1 < tokens.size(); i++) {
-            m.buttons.push_back(parseButton(tokens[i]));
+// Random machines for timing the wide-button path: every button toggles each
+// light with probability 1/3, and the target is the XOR of a random subset
+// so it is always reachable.
+vector<Machine> randomMachines(int count, int buttons, int lights, unsigned seed) {
+    mt19937_64 rng(seed);
+    uint64_t all = lights == 64 ? ~0ULL : (1ULL << lights) - 1;
+    vector<Machine> machines(count);
+    for (Machine &m : machines) {
+        m.num_lights = lights;
+        for (int b = 0; b < buttons; b++) {
+            uint64_t mask = (rng() & rng()) | (rng() & rng() & rng());
+            m.masks.push_back(mask & all);
+            if (rng() & 1) m.lights ^= m.masks.back();
+        }
+    }
+    return machines;
+}
+
+int main(int argc, char* argv[]) {
+    string engine = "auto";
+    string filename;
+    int threads = defaultThreads();
+    int rand_count = 0, rand_buttons = 0, rand_lights = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--engine" && i + 1 < argc) {
+            engine = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = stoi(argv[++i]);
+        } else if (arg == "--random" && i + 3 < argc) {
+            rand_count = stoi(argv[++i]);
+            rand_buttons = stoi(argv[++i]);
+            rand_lights = stoi(argv[++i]);
+        } else {
+            filename = arg;
         }
+    }
+    if (engine != "auto" && engine != "bfs" && engine != "mitm") {
+        cerr << "Unknown engine: " << engine << "\n";
+        return 1;
+    }
+    if (filename.empty() && rand_count == 0) {
+        cerr << "Usage: " << argv[0] << " input.txt [--engine auto|bfs|mitm] [--threads N]\n"
+             << "       " << argv[0] << " --random COUNT BUTTONS LIGHTS [--engine auto|bfs|mitm] [--threads N]\n";
+        return 1;
+    }
+    if (rand_count > 0 && (rand_buttons < 1 || rand_buttons > 48 || rand_lights < 1 || rand_lights > 63)) {
+        cerr << "--random needs 1..48 buttons and 1..63 lights\n";
+        return 1;
+    }
 
-        machines.push_back(m);
+    vector<Machine> machines;
+    if (rand_count > 0) machines = randomMachines(rand_count, rand_buttons, rand_lights, 10);
+
+    if (!filename.empty()) {
+        vector<MachineSpec> specs;
+        if (!parseMachineFile(filename, specs)) return 1;
+        for (const MachineSpec &spec : specs) {
+            if (spec.num_lights > 63) {
+                cerr << "Too many lights (" << spec.num_lights << ")\n";
+                return 1;
+            }
+            // The BFS visited set only has room for the diagram's lights
+            for (int light : spec.button_counters) {
+                if (light >= spec.num_lights) {
+                    cerr << "Machine " << machines.size() + 1 << ": button toggles light " << light
+                         << " but there are only " << spec.num_lights << " lights\n";
+                    return 1;
+                }
+            }
+            machines.push_back(Machine{spec.num_lights, spec.lights, spec.masks});
+        }
     }
 
+    auto start = chrono::steady_clock::now();
+    vector<double> cost;
+    for (auto &m : machines) cost.push_back(min(bfsCost(m), mitmCost(m)));
+    vector<int> presses(machines.size());
+    vector<double> machine_us = runMachines(cost, threads, [&](int i) {
+        const Machine &m = machines[i];
+        presses[i] = engine == "bfs" ? minPressesBfs(m) : engine == "mitm" ? minPressesMitm(m) : minPresses(m);
+    });
+    double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
     int total = 0;
-    for (auto &m : machines) {
-        int presses = minPresses(m);
-        if (presses == -1) {
+    for (int p : presses) {
+        if (p == -1) {
             cout << "Machine unreachable!\n";
         } else {
-            total += presses;
+            total += p;
         }
     }
 
     cout << "Fewest button presses: " << total << "\n";
+    cerr << machines.size() << " machines in " << us << " us ("
+         << (machines.empty() ? 0 : us / machines.size()) << " us/machine)\n";
+    printTimeHistogram(cerr, machine_us);
 }
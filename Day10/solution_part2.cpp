@@ -1,180 +1,393 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
-#include <queue>
-#include <unordered_set>
-#include <tuple>
 #include <string>
 #include <limits>
-#include <regex>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <sys/resource.h>
 
-using namespace std;
+#include "counter_lanes.h"
+#include "ilp_solver.h"
+#include "machine_parser.h"
+#include "machine_scheduler.h"
+#include "parity_solver.h"
 
-// State representation: tuple of counter values
-using State = vector<int>;
+using namespace std;
 
-// Hash function for vector<int> to use in unordered_set
-struct hash_vector {
-    size_t operator()(const vector<int>& v) const {
-        size_t seed = v.size();
-        for (auto& i : v) {
-            seed ^= i + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+// Every discovered state is interned once, as a fixed-width row of n counter
+// values in a flat arena. The visited set and the BFS queue hold only 32-bit
+// row indices. Rows are appended in discovery order, so the queue is a cursor
+// over the arena and a BFS level is a contiguous index range.
+//
+// Counter is the narrowest type that holds every target, uint8_t for most
+// machines; no counter ever goes past its target.
+template <typename Counter>
+class StateArena {
+public:
+    static constexpr uint32_t EMPTY = numeric_limits<uint32_t>::max();
+
+    explicit StateArena(int counters) : n_(counters), slots_(1024, EMPTY) {}
+
+    uint32_t size() const { return rows_; }
+    Counter* counters(uint32_t id) { return &counters_[(size_t)id * n_]; }
+
+    // Makes room for one more row past the end and returns its index. Row
+    // pointers taken before this call may be invalidated.
+    uint32_t scratch() {
+        if ((size_t)(rows_ + 1) * n_ > counters_.size()) {
+            size_t cap = max<size_t>(1024, 2 * (size_t)rows_);
+            counters_.resize(cap * n_);
         }
-        return seed;
+        return rows_;
     }
-};
 
-// Parse a single machine line for Part 2
-pair<vector<vector<int>>, vector<int>> parse_machine_part2(const string& line) {
-    vector<vector<int>> buttons;
-    vector<int> targets;
-
-    // Use regex to find button and target parts
-    regex button_regex(R"(\([^\)]+\))");
-    regex target_regex(R"(\{[^\}]+\})");
-
-    smatch match;
-    string::const_iterator search_start(line.cbegin());
-
-    // Find all buttons
-    while (regex_search(search_start, line.cend(), match, button_regex)) {
-        string button_str = match[0].str();
-        button_str = button_str.substr(1, button_str.size() - 2); // Remove parentheses
-
-        vector<int> button;
-        if (!button_str.empty()) {
-            stringstream ss(button_str);
-            string token;
-            while (getline(ss, token, ',')) {
-                button.push_back(stoi(token));
-            }
-        }
-        buttons.push_back(button);
-        search_start = match.suffix().first;
+    // Keeps the scratch row if its counters are new and returns its index;
+    // otherwise returns the index of the row that already holds them.
+    uint32_t commit() {
+        if (2 * ((size_t)rows_ + 1) > slots_.size()) grow();
+        uint32_t id = place(rows_);
+        if (id == rows_) rows_++;
+        return id;
     }
 
-    // Find target
-    if (regex_search(line, match, target_regex)) {
-        string target_str = match[0].str();
-        target_str = target_str.substr(1, target_str.size() - 2); // Remove braces
+private:
+    int n_;
+    uint32_t rows_ = 0;
+    vector<Counter> counters_;
+    vector<uint32_t> slots_;
+
+    size_t hash(uint32_t id) const {
+        const Counter* c = &counters_[(size_t)id * n_];
+        uint64_t h = 0x9E3779B97F4A7C15ULL;
+        for (int i = 0; i < n_; i++) h = (h ^ (uint16_t)c[i]) * 0x100000001B3ULL;
+        return (size_t)(h ^ (h >> 29));
+    }
 
-        stringstream ss(target_str);
-        string token;
-        while (getline(ss, token, ',')) {
-            targets.push_back(stoi(token));
+    uint32_t place(uint32_t id) {
+        size_t mask = slots_.size() - 1;
+        const Counter* c = &counters_[(size_t)id * n_];
+        for (size_t i = hash(id) & mask;; i = (i + 1) & mask) {
+            if (slots_[i] == EMPTY) return slots_[i] = id;
+            if (equal(c, c + n_, &counters_[(size_t)slots_[i] * n_])) return slots_[i];
         }
     }
 
-    return {buttons, targets};
-}
-
-int solve_machine_part2_bounded(const vector<vector<int>>& buttons, const vector<int>& targets, int max_presses_per_button = 50) {
-    int n = targets.size(); // number of counters
-    int m = buttons.size(); // number of buttons
-
-    State start_state(n, 0);
-    State target_state = targets;
+    void grow() {
+        slots_.assign(2 * slots_.size(), EMPTY);
+        for (uint32_t id = 0; id < rows_; id++) place(id);
+    }
+};
 
-    // BFS queue: tuple of (current_state, presses_used, press_counts)
-    using QueueItem = tuple<State, int, vector<int>>;
-    queue<QueueItem> q;
-    unordered_set<State, hash_vector> visited;
+// No path needs to count its presses: target pruning already stops button j
+// after machine.press_bound[j] presses, and buttons whose bound is 0 are
+// never tried.
+template <typename Counter>
+int forwardSearch(const LaneMachine& machine, long long* states) {
+    int n = machine.counters; // number of counters
+    int m = machine.num_buttons; // number of buttons
+    int blocks = machine.blocks;
+
+    StateArena<Counter> arena(n);
+    uint32_t start = arena.scratch();
+    fill(arena.counters(start), arena.counters(start) + n, 0);
+    arena.commit();
+
+    // The node being expanded and its successor, padded to lane blocks
+    vector<int16_t> current(machine.lanes(), 0), next_state(machine.lanes(), 0);
+    *states = 1;
+    if (sameCounters(current.data(), machine.target.data(), blocks)) return 0;
+
+    // BFS one level at a time: rows [head, level_end) are `presses` deep
+    uint32_t head = 0;
+    for (int presses = 0; head < arena.size(); presses++) {
+        uint32_t level_end = arena.size();
+        for (; head < level_end; head++) {
+            copy(arena.counters(head), arena.counters(head) + n, current.begin());
+
+            // Try pressing each button
+            for (int button_idx = 0; button_idx < m; ++button_idx) {
+                if (machine.press_bound[button_idx] == 0) {
+                    continue;
+                }
 
-    q.push(make_tuple(start_state, 0, vector<int>(m, 0)));
-    visited.insert(start_state);
+                // Apply button press, pruning if any counter exceeds its target
+                if (!pressButton(current.data(), machine.button(button_idx), machine.target.data(), next_state.data(), blocks)) {
+                    continue;
+                }
 
-    int best_cost = numeric_limits<int>::max();
+                uint32_t next = arena.scratch();
+                copy(next_state.begin(), next_state.begin() + n, arena.counters(next));
+                if (arena.commit() == next && sameCounters(next_state.data(), machine.target.data(), blocks)) {
+                    *states = arena.size();
+                    return presses + 1;
+                }
+            }
+        }
+    }
 
-    while (!q.empty()) {
-        auto [current_state, presses, press_counts] = q.front();
-        q.pop();
+    *states = arena.size();
+    return -1;
+}
 
-        if (current_state == target_state) {
-            best_cost = min(best_cost, presses);
-            continue;
+// Bidirectional variant: a forward search from zero that adds buttons and a
+// backward one from the target that subtracts them, floored at zero, intern
+// their states in one shared arena. Each row remembers which side found it
+// and how deep; a successor already owned by the other side is a meeting.
+// Forward states never exceed the target and backward states never drop
+// below zero, so both stay inside the same box.
+//
+// The side with the smaller frontier expands one whole level at a time, and
+// the search stops after the first level that meets, keeping its shortest
+// crossing. With unit-cost presses that crossing is a shortest path. As in
+// forwardSearch, the bounds on either side come from the target and the
+// zero floor, so paths carry no press counts.
+//
+// Opt-in with --mode bidirectional: it halves the states on machines with a
+// solution, but when there is none both sides expand until a frontier runs
+// dry, which costs more than the forward search alone.
+template <typename Counter>
+int bidirectionalSearch(const LaneMachine& machine, long long* states) {
+    int n = machine.counters;
+    int m = machine.num_buttons;
+    int blocks = machine.blocks;
+
+    vector<int16_t> current(machine.lanes(), 0), next_state(machine.lanes(), 0);
+    *states = 1;
+    if (sameCounters(current.data(), machine.target.data(), blocks)) return 0;
+
+    // Per row: the side that found it (1 = from the target) and its depth
+    StateArena<Counter> arena(n);
+    vector<uint8_t> from_target;
+    vector<int> depth;
+    vector<uint32_t> frontier[2], next_frontier;
+    auto seed = [&](const int16_t* counters, int side) {
+        uint32_t id = arena.scratch();
+        copy(counters, counters + n, arena.counters(id));
+        arena.commit();
+        from_target.push_back(side);
+        depth.push_back(0);
+        frontier[side].push_back(id);
+    };
+    seed(current.data(), 0);
+    seed(machine.target.data(), 1);
+
+    int best = -1;
+    while (best < 0 && !frontier[0].empty() && !frontier[1].empty()) {
+        int side = frontier[1].size() < frontier[0].size() ? 1 : 0;
+        next_frontier.clear();
+        for (uint32_t row : frontier[side]) {
+            copy(arena.counters(row), arena.counters(row) + n, current.begin());
+            for (int button_idx = 0; button_idx < m; ++button_idx) {
+                if (machine.press_bound[button_idx] == 0) continue;
+
+                bool inside = side == 0
+                    ? pressButton(current.data(), machine.button(button_idx), machine.target.data(), next_state.data(), blocks)
+                    : releaseButton(current.data(), machine.button(button_idx), next_state.data(), blocks);
+                if (!inside) continue;
+
+                uint32_t next = arena.scratch();
+                copy(next_state.begin(), next_state.begin() + n, arena.counters(next));
+                uint32_t found = arena.commit();
+                if (found == next) {
+                    from_target.push_back(side);
+                    depth.push_back(depth[row] + 1);
+                    next_frontier.push_back(next);
+                } else if (from_target[found] != side) {
+                    int length = depth[row] + 1 + depth[found];
+                    if (best < 0 || length < best) best = length;
+                }
+            }
         }
+        frontier[side].swap(next_frontier);
+    }
 
-        if (presses >= best_cost) {
-            continue;
-        }
+    *states = arena.size();
+    return best;
+}
 
-        // Try pressing each button
-        for (int button_idx = 0; button_idx < m; ++button_idx) {
-            if (press_counts[button_idx] >= max_presses_per_button) {
-                continue;
-            }
+int solve_machine_part2_bounded(const LaneMachine& machine, long long* states) {
+    return machine.max_target <= numeric_limits<uint8_t>::max() ? forwardSearch<uint8_t>(machine, states)
+                                                                : forwardSearch<int16_t>(machine, states);
+}
 
-            State new_state = current_state;
-            bool valid = true;
-
-            // Apply button press
-            for (int counter_idx : buttons[button_idx]) {
-                if (counter_idx < n) {
-                    new_state[counter_idx] += 1;
-                    // Prune if we exceed the target
-                    if (new_state[counter_idx] > targets[counter_idx]) {
-                        valid = false;
-                        break;
-                    }
-                }
-            }
+int solve_machine_part2_bidirectional(const LaneMachine& machine, long long* states) {
+    return machine.max_target <= numeric_limits<uint8_t>::max() ? bidirectionalSearch<uint8_t>(machine, states)
+                                                                : bidirectionalSearch<int16_t>(machine, states);
+}
 
-            if (!valid) {
-                continue;
-            }
+// Peak resident set size of this process so far, in KB
+long peak_rss_kb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
 
-            vector<int> new_press_counts = press_counts;
-            new_press_counts[button_idx] += 1;
+// Random machines in the input format, for cross-checking the solvers: every
+// button hits each counter with probability 1/3 (at least one), and the
+// targets are A x for a random press vector x with sum(x) <= max_target, so
+// they are reachable. Every fourth machine gets independent random targets
+// instead, which are often unreachable and exercise the "No solution" paths.
+vector<MachineSpec> randomMachines(int count, int buttons, int counters, int max_target, unsigned seed) {
+    mt19937_64 rng(seed);
+    vector<MachineSpec> specs;
+    for (int m = 0; m < count; m++) {
+        vector<vector<int>> lists(buttons);
+        for (auto& list : lists) {
+            for (int c = 0; c < counters; c++)
+                if (rng() % 3 == 0) list.push_back(c);
+            if (list.empty()) list.push_back(rng() % counters);
+        }
+        vector<int> targets(counters, 0);
+        if (m % 4 == 3) {
+            for (int& t : targets) t = rng() % (max_target + 1);
+        } else {
+            for (int left = rng() % (max_target + 1); left > 0; left--)
+                for (int c : lists[rng() % buttons]) targets[c]++;
+        }
 
-            if (visited.find(new_state) == visited.end()) {
-                visited.insert(new_state);
-                q.push(make_tuple(new_state, presses + 1, new_press_counts));
-            }
+        string line = "[" + string(counters, '.') + "]";
+        for (const auto& list : lists) {
+            line += " (";
+            for (size_t k = 0; k < list.size(); k++) line += (k ? "," : "") + to_string(list[k]);
+            line += ")";
         }
-    }
+        line += " {";
+        for (int c = 0; c < counters; c++) line += (c ? "," : "") + to_string(targets[c]);
+        line += "}";
 
-    return (best_cost != numeric_limits<int>::max()) ? best_cost : -1;
+        specs.emplace_back();
+        parseMachineLine(line.data(), line.data() + line.size(), specs.back());
+    }
+    return specs;
 }
 
 int main(int argc, char* argv[]) {
-    string filename;
-    if (argc > 1) {
-        filename = argv[1];
-    } else {
-        filename = "input.txt";
+    string filename = "input.txt";
+    string mode = "forward";
+    int threads = defaultThreads();
+    int rand_count = 0, rand_buttons = 0, rand_counters = 0, rand_max = 0;
+    unsigned seed = 10;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = stoi(argv[++i]);
+        } else if (arg == "--mode" && i + 1 < argc) {
+            mode = argv[++i];
+        } else if (arg == "--random" && i + 4 < argc) {
+            rand_count = stoi(argv[++i]);
+            rand_buttons = stoi(argv[++i]);
+            rand_counters = stoi(argv[++i]);
+            rand_max = stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = stoul(argv[++i]);
+        } else if (arg.rfind("--", 0) == 0) {
+            cerr << "Usage: " << argv[0] << " [input.txt] [--mode forward|bidirectional|compare] [--threads N]\n"
+                 << "       " << argv[0] << " --random COUNT BUTTONS COUNTERS MAX_PRESSES [--seed S] [--mode ...]\n";
+            return 1;
+        } else {
+            filename = arg;
+        }
     }
 
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Error opening file: " << filename << endl;
+    if (mode != "forward" && mode != "bidirectional" && mode != "compare") {
+        cerr << "Unknown mode: " << mode << " (expected forward, bidirectional or compare)" << endl;
         return 1;
     }
 
-    string line;
-    long long total_presses = 0;
-    int machine_count = 0;
+    if (rand_count > 0 && (rand_buttons < 1 || rand_counters < 1 || rand_counters > 64 || rand_max < 0)) {
+        cerr << "--random needs at least 1 button, 1..64 counters and MAX_PRESSES >= 0" << endl;
+        return 1;
+    }
 
-    while (getline(file, line)) {
-        if (line.empty()) continue;
+    // Parse every machine up front so they can be scheduled by cost
+    vector<MachineSpec> specs;
+    if (rand_count > 0) {
+        specs = randomMachines(rand_count, rand_buttons, rand_counters, rand_max, seed);
+    } else if (!parseMachineFile(filename, specs)) {
+        return 1;
+    }
+    vector<LaneMachine> machines(specs.size());
+    for (size_t i = 0; i < specs.size(); i++) {
+        if (!toLanes(specs[i], machines[i])) {
+            cerr << "Machine " << i + 1 << ": a target does not fit a 16-bit counter lane" << endl;
+            return 1;
+        }
+    }
 
-        auto [buttons, targets] = parse_machine_part2(line);
-        int min_presses = solve_machine_part2_bounded(buttons, targets);
+    vector<double> cost;
+    for (const MachineSpec& spec : specs) cost.push_back(part2Cost(spec.buttonLists(), spec.targets));
+
+    // In compare mode both searches run and must agree, and so must the ILP
+    // and parity solvers (-1 when they find no solution, skipped when a
+    // machine is outside what they take); states interned are reported per
+    // machine for each search
+    size_t count = machines.size();
+    vector<int> results(count), forward_results(count);
+    vector<long long> ilp_results(count, -1), parity_results(count, -1);
+    vector<char> parity_ran(count, 0);
+    vector<long long> bidirectional_states(count, 0), forward_states(count, 0);
+    vector<double> us = runMachines(cost, threads, [&](int i) {
+        if (mode != "forward") results[i] = solve_machine_part2_bidirectional(machines[i], &bidirectional_states[i]);
+        if (mode != "bidirectional") forward_results[i] = solve_machine_part2_bounded(machines[i], &forward_states[i]);
+        if (mode == "forward") results[i] = forward_results[i];
+        if (mode == "compare") {
+            ilp_results[i] = IlpSolver::solve(specs[i].buttonLists(), specs[i].targets);
+            if (machines[i].num_buttons <= ParitySolver::kMaxButtons && machines[i].counters <= 64) {
+                parity_results[i] = ParitySolver(machines[i]).solve();
+                parity_ran[i] = 1;
+            }
+        }
+    });
+
+    long long total_presses = 0, total_bidirectional = 0, total_forward = 0;
+    int machine_count = 0, mismatches = 0, solver_mismatches = 0;
+    for (size_t i = 0; i < count; i++) {
+        int counters = machines[i].counters, buttons = machines[i].num_buttons;
+        int min_presses = results[i];
+        total_bidirectional += bidirectional_states[i];
+        total_forward += forward_states[i];
+
+        string states;
+        if (mode == "compare") {
+            states = " (states: forward " + to_string(forward_states[i]) + ", bidirectional " +
+                     to_string(bidirectional_states[i]) + ")";
+            if (forward_results[i] != results[i]) {
+                states += " MISMATCH: forward gives " + to_string(forward_results[i]);
+                mismatches++;
+            }
+            if (ilp_results[i] != IlpSolver::kOverflow && ilp_results[i] != results[i]) {
+                states += " MISMATCH: ILP gives " + to_string(ilp_results[i]);
+                solver_mismatches++;
+            }
+            if (parity_ran[i] && parity_results[i] != results[i]) {
+                states += " MISMATCH: parity gives " + to_string(parity_results[i]);
+                solver_mismatches++;
+            }
+        } else {
+            states = " (" + to_string(mode == "forward" ? forward_states[i] : bidirectional_states[i]) + " states)";
+        }
 
         if (min_presses == -1) {
-            cout << "Machine " << targets.size() << " counters, " << buttons.size()
-                 << " buttons: No solution found (try increasing max_presses_per_button)" << endl;
+            cout << "Machine " << counters << " counters, " << buttons
+                 << " buttons: No solution" << states << pressBounds(machines[i]) << endl;
             continue;
         }
 
         total_presses += min_presses;
-        cout << "Machine " << targets.size() << " counters, " << buttons.size()
-             << " buttons: " << min_presses << " presses" << endl;
+        cout << "Machine " << counters << " counters, " << buttons
+             << " buttons: " << min_presses << " presses" << states << pressBounds(machines[i]) << endl;
         machine_count++;
     }
 
     cout << "Total minimum presses: " << total_presses << endl;
     cout << "Processed " << machine_count << " machines" << endl;
+    if (mode != "bidirectional") cout << "Forward states: " << total_forward << endl;
+    if (mode != "forward") cout << "Bidirectional states: " << total_bidirectional << endl;
+    if (mismatches) cout << mismatches << " machines disagree between forward and bidirectional search" << endl;
+    if (mode == "compare") cout << solver_mismatches << " disagreements with the ILP and parity solvers" << endl;
+    printTimeHistogram(cerr, us);
+    cerr << "Peak RSS: " << peak_rss_kb() << " KB" << endl;
 
     return 0;
 }
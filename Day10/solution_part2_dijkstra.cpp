@@ -1,6 +1,4 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <queue>
 #include <unordered_map>
@@ -8,131 +6,150 @@
 #include <tuple>
 #include <string>
 #include <limits>
-#include <regex>
 #include <functional>
 
-using namespace std;
-
-// State representation: vector of counter values
-using State = vector<int>;
+#include "counter_lanes.h"
+#include "machine_parser.h"
+#include "machine_scheduler.h"
 
-// Hash function for vector<int>
-struct hash_vector {
-    size_t operator()(const vector<int>& v) const {
-        size_t seed = v.size();
-        for (auto& i : v) {
-            seed ^= i + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-        }
-        return seed;
-    }
-};
-
-// Parse a single machine line for Part 2
-pair<vector<vector<int>>, vector<int>> parse_machine_part2(const string& line) {
-    vector<vector<int>> buttons;
-    vector<int> targets;
-
-    // Use regex to find button and target parts
-    regex button_regex(R"(\([^\)]+\))");
-    regex target_regex(R"(\{[^\}]+\})");
-
-    smatch match;
-    string::const_iterator search_start(line.cbegin());
-
-    // Find all buttons
-    while (regex_search(search_start, line.cend(), match, button_regex)) {
-        string button_str = match[0].str();
-        button_str = button_str.substr(1, button_str.size() - 2); // Remove parentheses
-
-        vector<int> button;
-        if (!button_str.empty()) {
-            stringstream ss(button_str);
-            string token;
-            while (getline(ss, token, ',')) {
-                button.push_back(stoi(token));
-            }
-        }
-        buttons.push_back(button);
-        search_start = match.suffix().first;
-    }
-
-    // Find target
-    if (regex_search(line, match, target_regex)) {
-        string target_str = match[0].str();
-        target_str = target_str.substr(1, target_str.size() - 2); // Remove braces
-
-        stringstream ss(target_str);
-        string token;
-        while (getline(ss, token, ',')) {
-            targets.push_back(stoi(token));
-        }
-    }
+using namespace std;
 
-    return {buttons, targets};
-}
+// State representation: counter values padded to SIMD lane blocks
+using State = LaneState;
 
-int solve_machine_part2_dijkstra(const vector<vector<int>>& buttons, const vector<int>& targets, int max_presses_per_button = 100) {
-    int n = targets.size(); // number of counters
-    int m = buttons.size(); // number of buttons
+int solve_machine_part2_dijkstra(const LaneMachine& machine, long long* expanded = nullptr) {
+    int blocks = machine.blocks;
+    int m = machine.num_buttons; // number of buttons
 
-    State start_state(n, 0);
-    State target_state = targets;
+    State start_state(machine.lanes(), 0);
+    const State& target_state = machine.target;
 
-    // Priority queue: (cost, state, press_counts)
-    using PQItem = tuple<int, State, vector<int>>;
-    priority_queue<PQItem, vector<PQItem>, greater<PQItem>> pq;
+    // Priority queue: (cost, state), cheapest first. Paths carry no press
+    // counts: target pruning already caps button j at machine.press_bound[j].
+    using PQItem = pair<int, State>;
+    auto by_cost = [](const PQItem& a, const PQItem& b) { return a.first > b.first; };
+    priority_queue<PQItem, vector<PQItem>, decltype(by_cost)> pq(by_cost);
 
     // Distance map
-    unordered_map<State, int, hash_vector> min_cost;
+    unordered_map<State, int, LaneStateHash, LaneStateEqual> min_cost;
 
-    pq.push(make_tuple(0, start_state, vector<int>(m, 0)));
+    pq.push(make_pair(0, start_state));
     min_cost[start_state] = 0;
 
     while (!pq.empty()) {
-        auto [cost, current_state, press_counts] = pq.top();
+        auto [cost, current_state] = pq.top();
         pq.pop();
 
         if (cost > min_cost[current_state]) {
             continue; // outdated entry
         }
 
-        if (current_state == target_state) {
+        if (sameCounters(current_state.data(), target_state.data(), blocks)) {
             return cost;
         }
+        if (expanded) (*expanded)++;
 
         // Try pressing each button
         for (int button_idx = 0; button_idx < m; ++button_idx) {
-            if (press_counts[button_idx] >= max_presses_per_button) {
+            if (machine.press_bound[button_idx] == 0) {
                 continue;
             }
 
-            State new_state = current_state;
-            bool valid = true;
-
-            // Apply button press
-            for (int counter_idx : buttons[button_idx]) {
-                if (counter_idx < n) {
-                    new_state[counter_idx] += 1;
-                    // Prune if we exceed the target
-                    if (new_state[counter_idx] > targets[counter_idx]) {
-                        valid = false;
-                        break;
-                    }
-                }
-            }
-
-            if (!valid) {
+            // Apply button press, pruning if any counter exceeds its target
+            State new_state(machine.lanes());
+            if (!pressButton(current_state.data(), machine.button(button_idx), target_state.data(), new_state.data(), blocks)) {
                 continue;
             }
 
-            vector<int> new_press_counts = press_counts;
-            new_press_counts[button_idx] += 1;
             int new_cost = cost + 1;
 
             // Check if this is better
             if (min_cost.find(new_state) == min_cost.end() || new_cost < min_cost[new_state]) {
                 min_cost[new_state] = new_cost;
-                pq.push(make_tuple(new_cost, new_state, new_press_counts));
+                pq.push(make_pair(new_cost, new_state));
+            }
+        }
+    }
+
+    return -1; // No solution found
+}
+
+// Lower bound on the presses still needed from `state`. A press raises
+// every counter by at most 1, so the largest remaining gap is a bound; it
+// also raises the total by at most the widest button's size, so the summed
+// gap over that width is another. Both drop by at most 1 per press, which
+// keeps the heuristic consistent.
+int remaining_presses_bound(const State& state, const State& target, int widest_button) {
+    int max_gap, sum_gap;
+    counterGaps(state.data(), target.data(), (int)state.size() / kCounterLanes, max_gap, sum_gap);
+    int spread = widest_button > 0 ? (sum_gap + widest_button - 1) / widest_button : 0;
+    return max(max_gap, spread);
+}
+
+// A* over the same graph as solve_machine_part2_dijkstra, ordered by
+// cost + remaining_presses_bound. Edges all cost 1 and the heuristic is
+// consistent, so f never decreases along a path and the frontier is a bucket
+// queue indexed by f; within a bucket the newest (deepest) node goes first.
+int solve_machine_part2_astar(const LaneMachine& machine, long long* expanded = nullptr) {
+    int blocks = machine.blocks;
+    int m = machine.num_buttons; // number of buttons
+
+    State start_state(machine.lanes(), 0);
+    const State& target_state = machine.target;
+
+    int widest_button = machine.widest_button;
+
+    // Frontier entries are node ids; a node is (state, cost)
+    vector<State> node_state;
+    vector<int> node_cost;
+    vector<vector<int>> buckets;
+    unordered_map<State, int, LaneStateHash, LaneStateEqual> min_cost;
+
+    auto push = [&](State state, int cost) {
+        int f = cost + remaining_presses_bound(state, target_state, widest_button);
+        if ((int)buckets.size() <= f) buckets.resize(f + 1);
+        buckets[f].push_back(node_state.size());
+        node_state.push_back(move(state));
+        node_cost.push_back(cost);
+    };
+
+    push(start_state, 0);
+    min_cost[start_state] = 0;
+
+    for (size_t f = 0; f < buckets.size(); ++f) {
+        while (!buckets[f].empty()) {
+            int id = buckets[f].back();
+            buckets[f].pop_back();
+            const State current_state = node_state[id];
+            int cost = node_cost[id];
+
+            if (cost > min_cost[current_state]) {
+                continue; // outdated entry
+            }
+
+            if (sameCounters(current_state.data(), target_state.data(), blocks)) {
+                return cost;
+            }
+            if (expanded) (*expanded)++;
+
+            // Try pressing each button
+            for (int button_idx = 0; button_idx < m; ++button_idx) {
+                if (machine.press_bound[button_idx] == 0) {
+                    continue;
+                }
+
+                // Apply button press, pruning if any counter exceeds its target
+                State new_state(machine.lanes());
+                if (!pressButton(current_state.data(), machine.button(button_idx), target_state.data(), new_state.data(), blocks)) {
+                    continue;
+                }
+
+                int new_cost = cost + 1;
+                auto it = min_cost.find(new_state);
+                if (it == min_cost.end() || new_cost < it->second) {
+                    min_cost[new_state] = new_cost;
+                    push(move(new_state), new_cost);
+                }
             }
         }
     }
@@ -141,43 +158,87 @@ int solve_machine_part2_dijkstra(const vector<vector<int>>& buttons, const vecto
 }
 
 int main(int argc, char* argv[]) {
-    string filename;
-    if (argc > 1) {
-        filename = argv[1];
-    } else {
-        filename = "input.txt";
+    string filename = "input.txt";
+    string mode = "astar";
+    int threads = defaultThreads();
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = stoi(argv[++i]);
+        } else if (arg == "--mode" && i + 1 < argc) {
+            mode = argv[++i];
+        } else {
+            filename = arg;
+        }
     }
 
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Error opening file: " << filename << endl;
+    if (mode != "dijkstra" && mode != "astar" && mode != "compare") {
+        cerr << "Unknown mode: " << mode << " (expected dijkstra, astar or compare)" << endl;
         return 1;
     }
 
-    string line;
-    long long total_presses = 0;
-    int machine_count = 0;
-
-    while (getline(file, line)) {
-        if (line.empty()) continue;
+    // Parse every machine up front so they can be scheduled by cost
+    vector<MachineSpec> specs;
+    if (!parseMachineFile(filename, specs)) return 1;
+    vector<LaneMachine> machines(specs.size());
+    for (size_t i = 0; i < specs.size(); i++) {
+        if (!toLanes(specs[i], machines[i])) {
+            cerr << "Machine " << i + 1 << ": a target does not fit a 16-bit counter lane" << endl;
+            return 1;
+        }
+    }
 
-        auto [buttons, targets] = parse_machine_part2(line);
-        int min_presses = solve_machine_part2_dijkstra(buttons, targets);
+    vector<double> cost;
+    for (const MachineSpec& spec : specs) cost.push_back(part2Cost(spec.buttonLists(), spec.targets));
+
+    // In compare mode both searches run and must agree; nodes expanded are
+    // reported per machine for each
+    size_t count = machines.size();
+    vector<int> results(count), dijkstra_results(count);
+    vector<long long> astar_nodes(count, 0), dijkstra_nodes(count, 0);
+    vector<double> us = runMachines(cost, threads, [&](int i) {
+        if (mode != "dijkstra") results[i] = solve_machine_part2_astar(machines[i], &astar_nodes[i]);
+        if (mode != "astar") dijkstra_results[i] = solve_machine_part2_dijkstra(machines[i], &dijkstra_nodes[i]);
+        if (mode == "dijkstra") results[i] = dijkstra_results[i];
+    });
+
+    long long total_presses = 0, total_astar = 0, total_dijkstra = 0;
+    int machine_count = 0, mismatches = 0;
+    for (size_t i = 0; i < count; i++) {
+        int counters = machines[i].counters, buttons = machines[i].num_buttons;
+        int min_presses = results[i];
+        total_astar += astar_nodes[i];
+        total_dijkstra += dijkstra_nodes[i];
+
+        string nodes;
+        if (mode == "compare") {
+            nodes = " (nodes expanded: Dijkstra " + to_string(dijkstra_nodes[i]) + ", A* " + to_string(astar_nodes[i]) + ")";
+            if (dijkstra_results[i] != results[i]) {
+                nodes += " MISMATCH: Dijkstra gives " + to_string(dijkstra_results[i]);
+                mismatches++;
+            }
+        } else {
+            nodes = " (" + to_string(mode == "astar" ? astar_nodes[i] : dijkstra_nodes[i]) + " nodes expanded)";
+        }
 
         if (min_presses == -1) {
-            cout << "Machine " << targets.size() << " counters, " << buttons.size()
-                 << " buttons: No solution found (try increasing max_presses_per_button)" << endl;
+            cout << "Machine " << counters << " counters, " << buttons
+                 << " buttons: No solution" << nodes << pressBounds(machines[i]) << endl;
             continue;
         }
 
         total_presses += min_presses;
-        cout << "Machine " << targets.size() << " counters, " << buttons.size()
-             << " buttons: " << min_presses << " presses" << endl;
+        cout << "Machine " << counters << " counters, " << buttons
+             << " buttons: " << min_presses << " presses" << nodes << pressBounds(machines[i]) << endl;
         machine_count++;
     }
 
     cout << "Total minimum presses: " << total_presses << endl;
     cout << "Processed " << machine_count << " machines" << endl;
+    if (mode != "astar") cout << "Dijkstra nodes expanded: " << total_dijkstra << endl;
+    if (mode != "dijkstra") cout << "A* nodes expanded: " << total_astar << endl;
+    if (mismatches) cout << mismatches << " machines disagree between Dijkstra and A*" << endl;
+    printTimeHistogram(cerr, us);
 
     return 0;
 }
@@ -0,0 +1,84 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include "ilp_solver.h"
+#include "machine_parser.h"
+#include "machine_scheduler.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string filename = "input.txt";
+    bool verbose = false;
+    int threads = defaultThreads();
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--verbose") {
+            verbose = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = stoi(argv[++i]);
+        } else {
+            filename = arg;
+        }
+    }
+
+    vector<MachineSpec> specs;
+    ParseStats parse;
+    if (!parseMachineFile(filename, specs, &parse)) return 1;
+    vector<vector<vector<int>>> buttons;
+    vector<vector<int>> targets;
+    for (const MachineSpec& spec : specs) {
+        buttons.push_back(spec.buttonLists());
+        targets.push_back(spec.targets);
+    }
+
+    auto start = chrono::steady_clock::now();
+    size_t n = targets.size();
+    vector<double> cost(n);
+    for (size_t i = 0; i < n; i++) cost[i] = part2Cost(buttons[i], targets[i]);
+    vector<long long> presses(n);
+    vector<IlpStats> stats(n);
+    vector<double> us = runMachines(cost, threads, [&](int i) {
+        presses[i] = IlpSolver::solve(buttons[i], targets[i], &stats[i]);
+    });
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    long long total_presses = 0, nodes = 0;
+    int machine_count = 0, unsolvable = 0, overflowed = 0;
+    for (size_t i = 0; i < n; i++) {
+        nodes += stats[i].nodes;
+        if (presses[i] == IlpSolver::kOverflow) {
+            cerr << "Machine " << i + 1 << ": arithmetic outgrew 64 bits, left unsolved" << endl;
+            overflowed++;
+            continue;
+        }
+        if (presses[i] < 0) {
+            cout << "Machine " << targets[i].size() << " counters, " << buttons[i].size()
+                 << " buttons: No solution" << endl;
+            unsolvable++;
+            continue;
+        }
+
+        total_presses += presses[i];
+        machine_count++;
+        if (verbose) {
+            cout << "Machine " << targets[i].size() << " counters, " << buttons[i].size() << " buttons: "
+                 << presses[i] << " presses (" << stats[i].free_vars << " free, " << stats[i].nodes << " nodes)"
+                 << endl;
+        }
+    }
+
+    cout << "Total minimum presses: " << total_presses << endl;
+    cout << "Processed " << machine_count << " machines" << endl;
+    if (unsolvable) cout << unsolvable << " machines have no solution" << endl;
+    if (overflowed) cout << overflowed << " machines overflowed and were not solved" << endl;
+    cerr << "Solved in " << ms << " ms on " << workerCount(threads, n) << " threads, " << nodes << " branch-and-bound nodes" << endl;
+    if (verbose) {
+        reportParse(parse, specs.size());
+        printTimeHistogram(cerr, us);
+    }
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+#include "counter_lanes.h"
+#include "ilp_solver.h"
+#include "machine_parser.h"
+#include "machine_scheduler.h"
+#include "parity_solver.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    string filename = "input.txt";
+    bool verbose = false;
+    int threads = defaultThreads();
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--verbose") {
+            verbose = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = stoi(argv[++i]);
+        } else {
+            filename = arg;
+        }
+    }
+
+    vector<MachineSpec> specs;
+    ParseStats parse;
+    if (!parseMachineFile(filename, specs, &parse)) return 1;
+    // Machines the parity solver cannot take (too many buttons to enumerate
+    // the subsets, more counters than a parity mask holds, or a target past
+    // the 16-bit lanes) are reported and handed to the ILP solver instead.
+    size_t n = specs.size();
+    vector<LaneMachine> machines(n);
+    vector<bool> use_ilp(n, false);
+    for (size_t i = 0; i < n; i++) {
+        if (!toLanes(specs[i], machines[i])) {
+            cerr << "Machine " << i + 1 << ": a target does not fit a 16-bit counter lane, using the ILP solver"
+                 << endl;
+            use_ilp[i] = true;
+        } else if (machines[i].num_buttons > ParitySolver::kMaxButtons || machines[i].counters > 64) {
+            cerr << "Machine " << i + 1 << ": more than " << ParitySolver::kMaxButtons
+                 << " buttons or 64 counters, using the ILP solver" << endl;
+            use_ilp[i] = true;
+        }
+    }
+
+    // Work is about 2^buttons subsets per level, log2(max target) levels
+    auto start = chrono::steady_clock::now();
+    vector<double> cost(n);
+    for (size_t i = 0; i < n; i++) {
+        if (use_ilp[i]) {
+            cost[i] = part2Cost(specs[i].buttonLists(), specs[i].targets);
+            continue;
+        }
+        int max_target = *max_element(machines[i].target.begin(), machines[i].target.end());
+        cost[i] = ldexp(log2(max_target + 2.0), machines[i].num_buttons);
+    }
+    vector<long long> presses(n);
+    vector<size_t> memo(n);
+    vector<double> us = runMachines(cost, threads, [&](int i) {
+        if (use_ilp[i]) {
+            presses[i] = IlpSolver::solve(specs[i].buttonLists(), specs[i].targets);
+            return;
+        }
+        ParitySolver solver(machines[i]);
+        presses[i] = solver.solve();
+        memo[i] = solver.memoEntries();
+    });
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    long long total_presses = 0;
+    size_t total_memo = 0;
+    int machine_count = 0, unsolvable = 0, by_ilp = 0, overflowed = 0;
+    for (size_t i = 0; i < n; i++) {
+        int counters = specs[i].counters(), buttons = specs[i].num_buttons();
+        by_ilp += use_ilp[i];
+        total_memo += memo[i];
+        if (use_ilp[i] && presses[i] == IlpSolver::kOverflow) {
+            cerr << "Machine " << i + 1 << ": ILP arithmetic outgrew 64 bits, left unsolved" << endl;
+            overflowed++;
+            continue;
+        }
+        if (presses[i] < 0) {
+            cout << "Machine " << counters << " counters, " << buttons << " buttons: No solution" << endl;
+            unsolvable++;
+            continue;
+        }
+
+        total_presses += presses[i];
+        machine_count++;
+        if (verbose && use_ilp[i]) {
+            cout << "Machine " << counters << " counters, " << buttons << " buttons: " << presses[i]
+                 << " presses (ILP)" << endl;
+        } else if (verbose) {
+            cout << "Machine " << counters << " counters, " << buttons << " buttons: " << presses[i]
+                 << " presses (" << memo[i] << " memoized targets)" << endl;
+        }
+    }
+
+    cout << "Total minimum presses: " << total_presses << endl;
+    cout << "Processed " << machine_count << " machines" << endl;
+    if (unsolvable) cout << unsolvable << " machines have no solution" << endl;
+    if (by_ilp) cout << by_ilp << " machines solved by the ILP solver" << endl;
+    if (overflowed) cout << overflowed << " machines overflowed and were not solved" << endl;
+    cerr << "Solved in " << ms << " ms on " << workerCount(threads, n) << " threads, " << total_memo << " memoized targets" << endl;
+    if (verbose) {
+        reportParse(parse, specs.size());
+        printTimeHistogram(cerr, us);
+    }
+
+    return 0;
+}
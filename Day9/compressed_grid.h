@@ -0,0 +1,132 @@
+#ifndef DAY9_COMPRESSED_GRID_H
+#define DAY9_COMPRESSED_GRID_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Rasterized polygon on coordinate-compressed axes.
+//
+// Every distinct red x (and y) gets its own column, and every gap between two
+// consecutive distinct values is collapsed into a single column between them,
+// plus one padding column on each side. A compressed cell is therefore either
+// entirely inside/on the polygon or entirely outside, and a rectangle with red
+// corners is valid iff it covers no outside cell. A 2D prefix sum over the
+// outside cells answers that with four lookups.
+class CompressedGrid {
+public:
+    template <typename PointT>
+    explicit CompressedGrid(const std::vector<PointT>& points) {
+        int n = points.size();
+        for (const PointT& p : points) {
+            xs_.push_back(p.x);
+            ys_.push_back(p.y);
+        }
+        std::sort(xs_.begin(), xs_.end());
+        xs_.erase(std::unique(xs_.begin(), xs_.end()), xs_.end());
+        std::sort(ys_.begin(), ys_.end());
+        ys_.erase(std::unique(ys_.begin(), ys_.end()), ys_.end());
+
+        width_ = 2 * (int)xs_.size() + 1;
+        height_ = 2 * (int)ys_.size() + 1;
+
+        col_.resize(n);
+        row_.resize(n);
+        for (int i = 0; i < n; ++i) {
+            col_[i] = compressX(points[i].x);
+            row_[i] = compressY(points[i].y);
+        }
+
+        // Draw the boundary, then flood the outside from the padding corner.
+        std::vector<uint8_t> cell((size_t)width_ * height_, UNKNOWN);
+        raster_bytes_ = cell.size();
+        for (int i = 0; i < n; ++i) {
+            int j = (i + 1) % n;
+            int c0 = std::min(col_[i], col_[j]), c1 = std::max(col_[i], col_[j]);
+            int r0 = std::min(row_[i], row_[j]), r1 = std::max(row_[i], row_[j]);
+            for (int r = r0; r <= r1; ++r)
+                for (int c = c0; c <= c1; ++c)
+                    cell[at(r, c)] = BOUNDARY;
+        }
+
+        std::vector<int> stack = {0};
+        cell[0] = OUTSIDE;
+        while (!stack.empty()) {
+            int idx = stack.back();
+            stack.pop_back();
+            int r = idx / width_, c = idx % width_;
+            const int dr[4] = {1, -1, 0, 0};
+            const int dc[4] = {0, 0, 1, -1};
+            for (int d = 0; d < 4; ++d) {
+                int nr = r + dr[d], nc = c + dc[d];
+                if (nr < 0 || nr >= height_ || nc < 0 || nc >= width_) continue;
+                int nidx = at(nr, nc);
+                if (cell[nidx] != UNKNOWN) continue;
+                cell[nidx] = OUTSIDE;
+                stack.push_back(nidx);
+            }
+        }
+
+        // prefix_[(r+1)*(W+1) + (c+1)] = outside cells in rows [0,r], cols [0,c]
+        prefix_.assign((size_t)(width_ + 1) * (height_ + 1), 0);
+        for (int r = 0; r < height_; ++r) {
+            for (int c = 0; c < width_; ++c) {
+                prefix_[psum(r + 1, c + 1)] = (cell[at(r, c)] == OUTSIDE) + prefix_[psum(r, c + 1)] +
+                                              prefix_[psum(r + 1, c)] - prefix_[psum(r, c)];
+            }
+        }
+    }
+
+    // O(1): the rectangle spanned by red tiles i and j lies inside the polygon.
+    bool isPairValid(int i, int j) const {
+        int c0 = std::min(col_[i], col_[j]), c1 = std::max(col_[i], col_[j]);
+        int r0 = std::min(row_[i], row_[j]), r1 = std::max(row_[i], row_[j]);
+        return outsideCount(r0, c0, r1, c1) == 0;
+    }
+
+    // O(log n): same test for any corners, red tiles or not.
+    bool isRectangleValid(long long left, long long bottom, long long right, long long top) const {
+        return outsideCount(compressY(bottom), compressX(left), compressY(top), compressX(right)) == 0;
+    }
+
+    size_t rasterBytes() const { return raster_bytes_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // Bytes held by the compressed axes, per-point indices and prefix table.
+    // The one-byte-per-cell raster is freed after construction; see rasterBytes().
+    size_t memoryBytes() const {
+        return xs_.capacity() * sizeof(long long) + ys_.capacity() * sizeof(long long) +
+               col_.capacity() * sizeof(int) + row_.capacity() * sizeof(int) +
+               prefix_.capacity() * sizeof(int32_t);
+    }
+
+private:
+    enum : uint8_t { UNKNOWN = 0, BOUNDARY = 1, OUTSIDE = 2 };
+
+    // A red coordinate maps to its own column; anything else to the gap
+    // column just before the next red value (or the padding at either end).
+    static int compress(const std::vector<long long>& axis, long long v) {
+        size_t k = std::lower_bound(axis.begin(), axis.end(), v) - axis.begin();
+        return 2 * (int)k + (k < axis.size() && axis[k] == v);
+    }
+    int compressX(long long x) const { return compress(xs_, x); }
+    int compressY(long long y) const { return compress(ys_, y); }
+
+    size_t at(int r, int c) const { return (size_t)r * width_ + c; }
+    size_t psum(int r, int c) const { return (size_t)r * (width_ + 1) + c; }
+
+    int32_t outsideCount(int r0, int c0, int r1, int c1) const {
+        return prefix_[psum(r1 + 1, c1 + 1)] - prefix_[psum(r0, c1 + 1)] -
+               prefix_[psum(r1 + 1, c0)] + prefix_[psum(r0, c0)];
+    }
+
+    std::vector<long long> xs_, ys_;
+    std::vector<int> col_, row_;
+    int width_ = 0, height_ = 0;
+    std::vector<int32_t> prefix_;
+    size_t raster_bytes_ = 0;
+};
+
+#endif
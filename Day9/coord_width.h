@@ -0,0 +1,126 @@
+#ifndef DAY9_COORD_WIDTH_H
+#define DAY9_COORD_WIDTH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Coordinate widths the Day9 solvers are instantiated for, and the type an
+// inclusive area (dx + 1) * (dy + 1) needs for each.
+//
+// int32_t is the dense path: it is only picked when every span is below
+// 2^31, so areas stay under 2^62. Anything else is read as int64_t, whose
+// areas can need up to 128 bits (coordinates near 2^40 give areas near 2^80).
+// Coordinates are limited to [-2^62, 2^62], which keeps every span below
+// 2^63 and every area below 2^126, inside a signed __int128.
+template <typename Coord> struct CoordTraits;
+
+template <> struct CoordTraits<int32_t> {
+    using Area = int64_t;
+    static constexpr const char* name = "int32";
+};
+
+template <> struct CoordTraits<int64_t> {
+    using Area = __int128;
+    static constexpr const char* name = "int64";
+};
+
+template <typename Coord> using AreaOf = typename CoordTraits<Coord>::Area;
+
+template <typename Coord> struct BasicPoint {
+    Coord x, y;
+};
+
+constexpr long long kCoordLimit = 1LL << 62;
+
+inline bool inCoordRange(long long v) { return v >= -kCoordLimit && v <= kCoordLimit; }
+
+// Whether every coordinate lies within [-kCoordLimit, kCoordLimit].
+inline bool fitsCoordRange(const std::vector<long long>& xs, const std::vector<long long>& ys) {
+    return std::all_of(xs.begin(), xs.end(), inCoordRange) && std::all_of(ys.begin(), ys.end(), inCoordRange);
+}
+
+// Whether the narrow layout can hold these coordinates.
+inline bool fitsInt32(const std::vector<long long>& xs, const std::vector<long long>& ys) {
+    auto fits = [](const std::vector<long long>& v) {
+        if (v.empty()) return true;
+        auto [lo, hi] = std::minmax_element(v.begin(), v.end());
+        return *lo >= std::numeric_limits<int32_t>::min() && *hi <= std::numeric_limits<int32_t>::max() &&
+               *hi - *lo < (1LL << 31);
+    };
+    return fits(xs) && fits(ys);
+}
+
+inline std::string areaToString(int64_t area) { return std::to_string(area); }
+
+inline std::string areaToString(__int128 area) {
+    if (area >= std::numeric_limits<int64_t>::min() && area <= std::numeric_limits<int64_t>::max())
+        return std::to_string((int64_t)area);
+    bool negative = area < 0;
+    unsigned __int128 v = negative ? -(unsigned __int128)area : (unsigned __int128)area;
+    std::string digits;
+    while (v > 0) {
+        digits += char('0' + (int)(v % 10));
+        v /= 10;
+    }
+    if (negative) digits += '-';
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+// Running maximum shared between search threads, used to prune pairs.
+// prunes(a) may answer false for an area that could in fact be pruned (an
+// extra containment check) but never true for one above the maximum.
+template <typename Area> class SharedMax {
+public:
+    bool prunes(Area area) const { return area <= best_.load(std::memory_order_relaxed); }
+
+    // Relaxed ordering is enough: the value is only a pruning hint, and any
+    // stale read just means an extra containment check.
+    void raise(Area area) {
+        Area cur = best_.load(std::memory_order_relaxed);
+        while (area > cur && !best_.compare_exchange_weak(cur, area, std::memory_order_relaxed)) {
+        }
+    }
+
+    Area get() const { return best_.load(); }
+
+private:
+    std::atomic<Area> best_{0};
+};
+
+// There is no lock-free 128-bit atomic on most targets, so the exact value
+// sits behind a mutex and readers prune against a double that never exceeds it.
+template <> class SharedMax<__int128> {
+public:
+    bool prunes(__int128 area) const {
+        double hint = hint_.load(std::memory_order_relaxed);
+        return area <= (__int128)hint;
+    }
+
+    void raise(__int128 area) {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (area <= best_) return;
+        best_ = area;
+        double hint = (double)area;
+        if ((__int128)hint > area) hint = std::nextafter(hint, 0.0);
+        hint_.store(hint, std::memory_order_relaxed);
+    }
+
+    __int128 get() const {
+        std::lock_guard<std::mutex> lock(mu_);
+        return best_;
+    }
+
+private:
+    mutable std::mutex mu_;
+    __int128 best_ = 0;
+    std::atomic<double> hint_{0.0};
+};
+
+#endif
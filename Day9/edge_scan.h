@@ -0,0 +1,109 @@
+#ifndef DAY9_EDGE_SCAN_H
+#define DAY9_EDGE_SCAN_H
+
+#include <algorithm>
+#include <vector>
+
+struct Point {
+    long long x, y;
+};
+
+struct VEdge {
+    long long x;
+    long long y_min, y_max;
+};
+
+struct HEdge {
+    long long y;
+    long long x_min, x_max;
+};
+
+// Edge lists sorted for binary search: v_edges by x, h_edges by y.
+struct EdgeLists {
+    std::vector<VEdge> v_edges;
+    std::vector<HEdge> h_edges;
+};
+
+inline EdgeLists buildEdges(const std::vector<Point>& points) {
+    EdgeLists edges;
+    int n = points.size();
+
+    for (int i = 0; i < n; ++i) {
+        Point p1 = points[i];
+        Point p2 = points[(i + 1) % n];
+
+        if (p1.x == p2.x) {
+            edges.v_edges.push_back({p1.x, std::min(p1.y, p2.y), std::max(p1.y, p2.y)});
+        } else if (p1.y == p2.y) {
+            edges.h_edges.push_back({p1.y, std::min(p1.x, p2.x), std::max(p1.x, p2.x)});
+        }
+    }
+
+    std::sort(edges.v_edges.begin(), edges.v_edges.end(), [](const VEdge& a, const VEdge& b) {
+        return a.x < b.x;
+    });
+    std::sort(edges.h_edges.begin(), edges.h_edges.end(), [](const HEdge& a, const HEdge& b) {
+        return a.y < b.y;
+    });
+    return edges;
+}
+
+// Linear-scan containment test over the sorted edge lists.
+inline bool isRectangleValidScan(const EdgeLists& edges, long long left, long long bottom,
+                                 long long right, long long top) {
+    const std::vector<VEdge>& v_edges = edges.v_edges;
+    const std::vector<HEdge>& h_edges = edges.h_edges;
+
+    // --- CHECK A: Vertical Edge Intersection ---
+    // Look for polygon edges strictly INSIDE the x-range (left, right)
+    auto it_v = std::upper_bound(v_edges.begin(), v_edges.end(), left,
+        [](long long val, const VEdge& e) { return val < e.x; });
+
+    for (; it_v != v_edges.end(); ++it_v) {
+        if (it_v->x >= right) break;
+        // Check if this vertical edge cuts through the rectangle's Y range
+        // Intersection of (y_min, y_max) and (bottom, top)
+        // We use strict > bottom and < top to ensure we don't count touching boundaries
+        if (it_v->y_min < top && it_v->y_max > bottom) {
+            return false;
+        }
+    }
+
+    // --- CHECK B: Horizontal Edge Intersection ---
+    auto it_h = std::upper_bound(h_edges.begin(), h_edges.end(), bottom,
+        [](long long val, const HEdge& e) { return val < e.y; });
+
+    for (; it_h != h_edges.end(); ++it_h) {
+        if (it_h->y >= top) break;
+        if (it_h->x_min < right && it_h->x_max > left) {
+            return false;
+        }
+    }
+
+    // --- CHECK C: Enclosure (Point in Polygon) ---
+    // Ray Casting from the center-bottom of the rectangle.
+    // Conceptual Ray Origin: x = left + epsilon, y = bottom + 0.5
+    // Actually, since we proved no edges are *inside* (left, right),
+    // we can cast a ray from anywhere in that X range.
+    // We check how many vertical edges are to the RIGHT (x >= right).
+
+    // We need to count edges that cover the Y-slice [bottom, bottom+1]
+    // i.e., edge.y_min <= bottom AND edge.y_max > bottom
+
+    // Start searching for edges at x >= right (boundary is included in ray check)
+    auto it_ray = std::lower_bound(v_edges.begin(), v_edges.end(), right,
+        [](const VEdge& e, long long val) { return e.x < val; });
+
+    long long intersections = 0;
+    for (; it_ray != v_edges.end(); ++it_ray) {
+        // Does this edge cross the line y = bottom + 0.5?
+        if (it_ray->y_min <= bottom && it_ray->y_max > bottom) {
+            intersections++;
+        }
+    }
+
+    // Odd intersections = Inside
+    return intersections % 2 != 0;
+}
+
+#endif
@@ -0,0 +1,227 @@
+#ifndef DAY9_EDGE_SIMD_H
+#define DAY9_EDGE_SIMD_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "edge_scan.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define DAY9_X86_KERNELS 1
+#endif
+
+// Structure-of-arrays copy of one sorted edge list: key is the fixed
+// coordinate (x for vertical edges, y for horizontal), [lo, hi] the span.
+struct EdgeSoA {
+    std::vector<long long> key, lo, hi;
+
+    void push(long long k, long long l, long long h) {
+        key.push_back(k);
+        lo.push_back(l);
+        hi.push_back(h);
+    }
+};
+
+struct EdgeSoAPair {
+    EdgeSoA vertical, horizontal;
+};
+
+inline EdgeSoAPair toSoA(const EdgeLists& edges) {
+    EdgeSoAPair soa;
+    for (const VEdge& e : edges.v_edges) soa.vertical.push(e.x, e.y_min, e.y_max);
+    for (const HEdge& e : edges.h_edges) soa.horizontal.push(e.y, e.x_min, e.x_max);
+    return soa;
+}
+
+// An edge kernel is a type with two batch operations over one EdgeSoA:
+//
+//   overlapRun(e, begin, limit, qlo, qhi): walks edges from `begin` while
+//     key < limit. Returns kOverlap if one of them has lo < qhi && hi > qlo,
+//     otherwise the index of the first edge with key >= limit.
+//   countStab(lo, hi, begin, end, at): number of edges in [begin, end) with
+//     lo <= at && hi > at.
+//
+// The run walk finds the end of the run itself, so a rectangle costs two
+// binary searches (the scan engine needs three), and check C starts where
+// check A's run stopped. Kernel::isRectangleValid is the whole test compiled
+// for that kernel's instruction set, so the batch operations inline into it;
+// searches are templated on the kernel and call it directly.
+constexpr size_t kOverlap = ~(size_t)0;
+
+template <typename Kernel>
+inline bool isRectangleValidWith(const EdgeSoAPair& soa, long long left, long long bottom, long long right,
+                                 long long top);
+
+struct ScalarEdgeKernel {
+    static constexpr const char* name = "scalar";
+
+    static size_t overlapRun(const EdgeSoA& e, size_t begin, long long limit, long long qlo, long long qhi) {
+        size_t i = begin, size = e.key.size();
+        for (; i < size && e.key[i] < limit; ++i)
+            if (e.lo[i] < qhi && e.hi[i] > qlo) return kOverlap;
+        return i;
+    }
+
+    static size_t countStab(const long long* lo, const long long* hi, size_t begin, size_t end, long long at) {
+        size_t count = 0;
+        for (size_t i = begin; i < end; ++i) count += (lo[i] <= at) & (hi[i] > at);
+        return count;
+    }
+
+    static bool isRectangleValid(const EdgeSoAPair& soa, long long left, long long bottom, long long right,
+                                 long long top) {
+        return isRectangleValidWith<ScalarEdgeKernel>(soa, left, bottom, right, top);
+    }
+};
+
+#ifdef DAY9_X86_KERNELS
+
+struct Avx2EdgeKernel {
+    static constexpr const char* name = "avx2";
+
+    __attribute__((target("avx2,popcnt")))
+    static size_t overlapRun(const EdgeSoA& e, size_t begin, long long limit, long long qlo, long long qhi) {
+        const __m256i vlimit = _mm256_set1_epi64x(limit);
+        const __m256i vqlo = _mm256_set1_epi64x(qlo), vqhi = _mm256_set1_epi64x(qhi);
+        size_t i = begin, size = e.key.size();
+        for (; i + 4 <= size; i += 4) {
+            __m256i k = _mm256_loadu_si256((const __m256i*)(e.key.data() + i));
+            __m256i l = _mm256_loadu_si256((const __m256i*)(e.lo.data() + i));
+            __m256i h = _mm256_loadu_si256((const __m256i*)(e.hi.data() + i));
+            __m256i in_run = _mm256_cmpgt_epi64(vlimit, k);
+            __m256i hit = _mm256_and_si256(in_run, _mm256_and_si256(_mm256_cmpgt_epi64(vqhi, l),
+                                                                     _mm256_cmpgt_epi64(h, vqlo)));
+            if (!_mm256_testz_si256(hit, hit)) return kOverlap;
+            // Keys are sorted, so the run ends at the first lane outside it
+            int outside = ~_mm256_movemask_pd(_mm256_castsi256_pd(in_run)) & 0xF;
+            if (outside) return i + __builtin_ctz(outside);
+        }
+        return ScalarEdgeKernel::overlapRun(e, i, limit, qlo, qhi);
+    }
+
+    __attribute__((target("avx2,popcnt")))
+    static size_t countStab(const long long* lo, const long long* hi, size_t begin, size_t end, long long at) {
+        const __m256i vat = _mm256_set1_epi64x(at);
+        size_t count = 0, i = begin;
+        for (; i + 4 <= end; i += 4) {
+            __m256i l = _mm256_loadu_si256((const __m256i*)(lo + i));
+            __m256i h = _mm256_loadu_si256((const __m256i*)(hi + i));
+            // lo <= at is !(lo > at)
+            __m256i hit = _mm256_andnot_si256(_mm256_cmpgt_epi64(l, vat), _mm256_cmpgt_epi64(h, vat));
+            count += _mm_popcnt_u32(_mm256_movemask_pd(_mm256_castsi256_pd(hit)));
+        }
+        return count + ScalarEdgeKernel::countStab(lo, hi, i, end, at);
+    }
+
+    __attribute__((target("avx2,popcnt"), flatten))
+    static bool isRectangleValid(const EdgeSoAPair& soa, long long left, long long bottom, long long right,
+                                 long long top) {
+        return isRectangleValidWith<Avx2EdgeKernel>(soa, left, bottom, right, top);
+    }
+};
+
+struct Avx512EdgeKernel {
+    static constexpr const char* name = "avx512";
+
+    __attribute__((target("avx512f,popcnt")))
+    static size_t overlapRun(const EdgeSoA& e, size_t begin, long long limit, long long qlo, long long qhi) {
+        const __m512i vlimit = _mm512_set1_epi64(limit);
+        const __m512i vqlo = _mm512_set1_epi64(qlo), vqhi = _mm512_set1_epi64(qhi);
+        size_t i = begin, size = e.key.size();
+        for (; i + 8 <= size; i += 8) {
+            __m512i k = _mm512_loadu_si512(e.key.data() + i);
+            __m512i l = _mm512_loadu_si512(e.lo.data() + i);
+            __m512i h = _mm512_loadu_si512(e.hi.data() + i);
+            __mmask8 in_run = _mm512_cmplt_epi64_mask(k, vlimit);
+            __mmask8 hit = _mm512_mask_cmpgt_epi64_mask(_mm512_mask_cmplt_epi64_mask(in_run, l, vqhi), h, vqlo);
+            if (hit) return kOverlap;
+            // Keys are sorted, so the run ends at the first lane outside it
+            unsigned outside = ~(unsigned)in_run & 0xFF;
+            if (outside) return i + __builtin_ctz(outside);
+        }
+        return ScalarEdgeKernel::overlapRun(e, i, limit, qlo, qhi);
+    }
+
+    __attribute__((target("avx512f,popcnt")))
+    static size_t countStab(const long long* lo, const long long* hi, size_t begin, size_t end, long long at) {
+        const __m512i vat = _mm512_set1_epi64(at);
+        size_t count = 0, i = begin;
+        for (; i + 8 <= end; i += 8) {
+            __m512i l = _mm512_loadu_si512(lo + i);
+            __m512i h = _mm512_loadu_si512(hi + i);
+            __mmask8 hit = _mm512_mask_cmpgt_epi64_mask(_mm512_cmple_epi64_mask(l, vat), h, vat);
+            count += _mm_popcnt_u32(hit);
+        }
+        return count + ScalarEdgeKernel::countStab(lo, hi, i, end, at);
+    }
+
+    __attribute__((target("avx512f,popcnt"), flatten))
+    static bool isRectangleValid(const EdgeSoAPair& soa, long long left, long long bottom, long long right,
+                                 long long top) {
+        return isRectangleValidWith<Avx512EdgeKernel>(soa, left, bottom, right, top);
+    }
+};
+
+#endif
+
+// Same checks A-C as isRectangleValidScan, with each run of edges walked in
+// batches by Kernel.
+template <typename Kernel>
+inline bool isRectangleValidWith(const EdgeSoAPair& soa, long long left, long long bottom, long long right,
+                                 long long top) {
+    const EdgeSoA& v = soa.vertical;
+    const EdgeSoA& h = soa.horizontal;
+
+    // A: vertical edges with left < x < right crossing (bottom, top). The run
+    // stops at the first x >= right, where the ray of check C starts; for a
+    // zero-width rectangle that is the first x >= left.
+    size_t vb = (left < right ? std::upper_bound(v.key.begin(), v.key.end(), left)
+                              : std::lower_bound(v.key.begin(), v.key.end(), left)) - v.key.begin();
+    size_t ray = Kernel::overlapRun(v, vb, right, bottom, top);
+    if (ray == kOverlap) return false;
+
+    // B: horizontal edges with bottom < y < top crossing (left, right)
+    size_t hb = std::upper_bound(h.key.begin(), h.key.end(), bottom) - h.key.begin();
+    if (Kernel::overlapRun(h, hb, top, left, right) == kOverlap) return false;
+
+    // C: ray from (right, bottom + 0.5) towards +x
+    return Kernel::countStab(v.lo.data(), v.hi.data(), ray, v.key.size(), bottom) % 2 != 0;
+}
+
+// Calls visit(Kernel{}) for every kernel this build and CPU can run, widest
+// first.
+template <typename Visit>
+void forEachEdgeKernel(const Visit& visit) {
+#ifdef DAY9_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) visit(Avx512EdgeKernel{});
+    if (__builtin_cpu_supports("avx2")) visit(Avx2EdgeKernel{});
+#endif
+    visit(ScalarEdgeKernel{});
+}
+
+// Calls visit(Kernel{}) once, with the named kernel if available, otherwise
+// the widest one. The kernel is chosen here, once; everything visit
+// instantiates is compiled against it.
+template <typename Visit>
+void withEdgeKernel(const std::string& name, const Visit& visit) {
+    bool named = false;
+    forEachEdgeKernel([&](auto kernel) { named = named || name == kernel.name; });
+    bool done = false;
+    forEachEdgeKernel([&](auto kernel) {
+        if (done || (named && name != kernel.name)) return;
+        done = true;
+        visit(kernel);
+    });
+}
+
+inline std::vector<std::string> edgeKernelNames() {
+    std::vector<std::string> names;
+    forEachEdgeKernel([&](auto kernel) { names.push_back(kernel.name); });
+    return names;
+}
+
+#endif
@@ -0,0 +1,412 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <random>
+
+#include "compressed_grid.h"
+#include "edge_scan.h"
+#include "edge_simd.h"
+#include "incremental_solver.h"
+#include "polygon_gen.h"
+#include "polygon_index.h"
+#include "reference_check.h"
+#include "staircase.h"
+
+using namespace std;
+
+// Differential fuzz harness for the Day9 solvers.
+//
+// For every generated polygon, each red-tile pair is validated by the part 2
+// engines (scan, index, grid, and simd with every kernel the CPU supports)
+// and by the exact reference in reference_check.h; on small coordinates the
+// tile-by-tile walk joins in as well. Part 1's staircase engine is checked
+// against the pair loop on the same points, in both coordinate widths. Any
+// disagreement is printed with the seed that reproduces it.
+//
+// With --kernels EDGES, only the batch kernels are timed, on EDGES random
+// edges, against the scalar kernel.
+//
+// With --edits N, each polygon also drives an IncrementalSolver through N
+// small random rectilinear edits (edge moves and collinear tile inserts and
+// removals, which keep the loop rectilinear though not necessarily simple)
+// and compares every query() with a full recompute, once as generated and
+// once with every coordinate scaled by 2^30 onto the 128-bit area path.
+//
+// The scan and index engines ray-cast from just above the bottom edge, so
+// they reject zero-height/width strips running along the top of the polygon
+// that the tile rules accept. Those are counted as "strips", not mismatches.
+//
+// Every size also runs with min_gap 1, where parallel edges can sit on
+// adjacent tiles. The sliver between them holds no tile, so the tile rules
+// count it as covered while every engine sees outside (the notch polygon
+// 0,0 10,0 10,10 6,10 6,2 5,2 5,10 0,10 gives 121 by tiles, 66 by engine).
+// Engine-vs-exact disagreements there are counted as "adjacent" when the
+// engines agree among themselves (strips aside), and the smallest polygon showing one is
+// written to adjacent_repro.txt in the input format.
+
+struct Rect {
+    int i, j;
+    long long left, bottom, right, top;
+};
+
+// Smallest case seen where the engines and the tile rules part ways.
+struct Repro {
+    bool found = false;
+    PolygonSpec spec;
+    Rect rect;
+    vector<Point> points;
+};
+
+struct Totals {
+    long long cases = 0, pairs = 0, mismatches = 0, strips = 0, adjacent = 0;
+    double scan_ns = 0, index_ns = 0, grid_ns = 0, simd_ns = 0, exact_ns = 0;
+};
+
+template <typename Check>
+vector<char> timeAll(const vector<Rect>& rects, double& ns, const Check& check) {
+    vector<char> out(rects.size());
+    auto start = chrono::steady_clock::now();
+    for (size_t k = 0; k < rects.size(); ++k) out[k] = check(rects[k]);
+    ns += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    return out;
+}
+
+void reportMismatch(const char* what, const PolygonSpec& spec, const Rect& r) {
+    cout << "MISMATCH " << what << ": vertices=" << spec.vertices << " range=" << spec.coord_range
+         << " concavity=" << spec.concavity << " seed=" << spec.seed << " rect=(" << r.left << ","
+         << r.bottom << ")-(" << r.right << "," << r.top << ")" << endl;
+}
+
+void runCase(const PolygonSpec& spec, size_t max_pairs, Totals& totals, Repro& repro) {
+    vector<pair<long long, long long>> reds = generatePolygon(spec);
+    vector<Point> points;
+    for (auto& p : reds) points.push_back({p.first, p.second});
+    int n = points.size();
+
+    EdgeLists edges = buildEdges(points);
+    PolygonIndex index(points);
+    CompressedGrid grid(points);
+    EdgeSoAPair soa = toSoA(edges);
+
+    vector<Rect> rects;
+    auto addPair = [&](int i, int j) {
+        rects.push_back({i, j, min(points[i].x, points[j].x), min(points[i].y, points[j].y),
+                         max(points[i].x, points[j].x), max(points[i].y, points[j].y)});
+    };
+    if ((size_t)n * (n - 1) / 2 <= max_pairs) {
+        for (int i = 0; i < n; ++i)
+            for (int j = i + 1; j < n; ++j) addPair(i, j);
+    } else {
+        mt19937 rng(spec.seed);
+        uniform_int_distribution<int> pick(0, n - 1);
+        while (rects.size() < max_pairs) {
+            int i = pick(rng), j = pick(rng);
+            if (i != j) addPair(min(i, j), max(i, j));
+        }
+    }
+
+    vector<char> scan = timeAll(rects, totals.scan_ns, [&](const Rect& r) {
+        return isRectangleValidScan(edges, r.left, r.bottom, r.right, r.top);
+    });
+    vector<char> idx = timeAll(rects, totals.index_ns, [&](const Rect& r) {
+        return index.isRectangleValid(r.left, r.bottom, r.right, r.top);
+    });
+    vector<char> grd = timeAll(rects, totals.grid_ns, [&](const Rect& r) {
+        return grid.isPairValid(r.i, r.j);
+    });
+    // Timing uses the widest kernel; narrower ones are only checked.
+    vector<string> kernels = edgeKernelNames();
+    vector<vector<char>> simd;
+    forEachEdgeKernel([&](auto kernel) {
+        using Kernel = decltype(kernel);
+        double ignored = 0;
+        simd.push_back(timeAll(rects, simd.empty() ? totals.simd_ns : ignored, [&](const Rect& r) {
+            return Kernel::isRectangleValid(soa, r.left, r.bottom, r.right, r.top);
+        }));
+    });
+    vector<char> exact = timeAll(rects, totals.exact_ns, [&](const Rect& r) {
+        return isRectangleValid(r.left, r.bottom, r.right, r.top, reds);
+    });
+
+    bool small = spec.coord_range <= 200;
+    bool gap1 = spec.min_gap <= 1;
+    for (size_t k = 0; k < rects.size(); ++k) {
+        const Rect& r = rects[k];
+        bool strip = r.left == r.right || r.bottom == r.top;
+        bool diverges = false;
+        if (grd[k] != exact[k]) {
+            if (gap1 && (grd[k] == scan[k] || strip)) diverges = true;
+            else { reportMismatch("grid vs exact", spec, r); totals.mismatches++; }
+        }
+        if (scan[k] != idx[k]) { reportMismatch("scan vs index", spec, r); totals.mismatches++; }
+        for (size_t s = 0; s < kernels.size(); ++s) {
+            if (scan[k] != simd[s][k]) {
+                reportMismatch(("scan vs simd " + kernels[s]).c_str(), spec, r);
+                totals.mismatches++;
+            }
+        }
+        if (scan[k] != exact[k]) {
+            if (strip) totals.strips++;
+            else if (gap1) diverges = true;
+            else { reportMismatch("scan vs exact", spec, r); totals.mismatches++; }
+        }
+        if (diverges) {
+            totals.adjacent++;
+            if (!repro.found || points.size() < repro.points.size()) repro = {true, spec, r, points};
+        }
+        if (small && exact[k] != isRectangleValidByTiles(r.left, r.bottom, r.right, r.top, reds)) {
+            reportMismatch("exact vs tiles", spec, r);
+            totals.mismatches++;
+        }
+    }
+
+    // Part 1 in both coordinate widths; the int32 layout only where it fits.
+    vector<pair<int64_t, int64_t>> wide(reds.begin(), reds.end());
+    AreaOf<int64_t> wide_area = staircaseMaxArea(wide);
+    bool part1_ok = wide_area == bruteForceMaxArea(wide);
+    if (spec.coord_range <= INT_MAX) {
+        vector<pair<int32_t, int32_t>> ints(reds.begin(), reds.end());
+        AreaOf<int32_t> narrow_area = staircaseMaxArea(ints);
+        part1_ok &= narrow_area == bruteForceMaxArea(ints) && narrow_area == wide_area;
+    }
+    if (!part1_ok) {
+        cout << "MISMATCH part 1: vertices=" << spec.vertices << " seed=" << spec.seed << endl;
+        totals.mismatches++;
+    }
+
+    totals.cases++;
+    totals.pairs += rects.size();
+}
+
+// Full pruned pair loop over the scan engine, as solution2 runs it.
+template <typename Coord>
+AreaOf<Coord> fullScanMaxArea(const vector<Point>& points) {
+    using Area = AreaOf<Coord>;
+    EdgeLists edges = buildEdges(points);
+    int n = points.size();
+    Area best = 0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = i + 1; j < n; ++j) {
+            long long l = min(points[i].x, points[j].x), r = max(points[i].x, points[j].x);
+            long long b = min(points[i].y, points[j].y), t = max(points[i].y, points[j].y);
+            Area area = ((Area)r - l + 1) * ((Area)t - b + 1);
+            if (area > best && isRectangleValidScan(edges, l, b, r, t)) best = area;
+        }
+    }
+    return best;
+}
+
+// Coordinates are multiplied by `scale`; with Coord = int64_t and a scale of
+// 2^30 the areas only fit the 128-bit path.
+template <typename Coord>
+void runIncrementalCase(const PolygonSpec& spec, long long scale, int edits, Totals& totals, double& full_ms,
+                        double& incr_ms, long long& rechecked) {
+    vector<Point> points;
+    for (auto& p : generatePolygon(spec)) points.push_back({p.first * scale, p.second * scale});
+    IncrementalSolver<Coord> solver(points);
+    solver.query();
+
+    // Each edit is one of the rectilinear operations, drawn at random and
+    // redrawn until one applies: move a vertical or horizontal edge, insert
+    // a red tile on an edge, or remove one that lies between collinear
+    // neighbours. Inserting two tiles on an edge and moving the edge between
+    // them cuts a notch.
+    mt19937 rng(spec.seed ^ 0x9e3779b9u);
+    uniform_int_distribution<int> op(0, 3);
+    long long reach = max(2LL, spec.coord_range / 50) * scale;
+    uniform_int_distribution<long long> shift(-reach, reach);
+    for (int e = 0; e < edits; ++e) {
+        bool applied = false;
+        while (!applied) {
+            int n = solver.size();
+            int k = uniform_int_distribution<int>(0, n - 1)(rng);
+            Point a = solver.vertexAt(k), b = solver.vertexAt((k + 1) % n);
+            switch (op(rng)) {
+            case 0:
+                applied = solver.moveVerticalEdge(k, a.x + shift(rng));
+                break;
+            case 1:
+                applied = solver.moveHorizontalEdge(k, a.y + shift(rng));
+                break;
+            case 2: {
+                double f = uniform_real_distribution<double>(0, 1)(rng);
+                Point p = {a.x + (long long)((b.x - a.x) * f), a.y + (long long)((b.y - a.y) * f)};
+                applied = solver.insertCollinearVertex((k + 1) % n, p);
+                break;
+            }
+            default:
+                applied = solver.removeCollinearVertex(k);
+                break;
+            }
+        }
+
+        auto t0 = chrono::steady_clock::now();
+        AreaOf<Coord> incremental = solver.query();
+        auto t1 = chrono::steady_clock::now();
+        AreaOf<Coord> full = fullScanMaxArea<Coord>(solver.points());
+        auto t2 = chrono::steady_clock::now();
+        incr_ms += chrono::duration<double, milli>(t1 - t0).count();
+        full_ms += chrono::duration<double, milli>(t2 - t1).count();
+        rechecked += solver.lastRechecked();
+
+        if (incremental != full) {
+            cout << "MISMATCH incremental: vertices=" << spec.vertices << " seed=" << spec.seed
+                 << " scale=" << scale << " edit=" << e << " got " << areaToString(incremental)
+                 << " expected " << areaToString(full) << endl;
+            totals.mismatches++;
+            return;
+        }
+    }
+}
+
+// Times each kernel's batch operations on their own, over `edges` random
+// edges: a run walk that covers every edge without finding an overlap, and a
+// stab count over every edge. This is the kernel speedup, not a per-rectangle
+// one; the default table times the rectangle tests.
+void benchKernels(size_t edges, int reps) {
+    mt19937_64 rng(1);
+    uniform_int_distribution<long long> coord(0, 1000000);
+    EdgeSoA soa;
+    for (size_t k = 0; k < edges; ++k) {
+        long long a = coord(rng), b = coord(rng);
+        soa.push((long long)k, min(a, b), max(a, b));
+    }
+
+    struct Row {
+        string name;
+        double run_ns, stab_ns;
+    };
+    vector<Row> rows;
+    volatile size_t sink = 0;
+    forEachEdgeKernel([&](auto kernel) {
+        using Kernel = decltype(kernel);
+        auto t0 = chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+            sink = sink + Kernel::overlapRun(soa, 0, (long long)edges, 2000000 + r, 3000000);
+        auto t1 = chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+            sink = sink + Kernel::countStab(soa.lo.data(), soa.hi.data(), 0, edges, 500000 + r);
+        auto t2 = chrono::steady_clock::now();
+        rows.push_back({Kernel::name, chrono::duration<double, nano>(t1 - t0).count() / reps,
+                        chrono::duration<double, nano>(t2 - t1).count() / reps});
+    });
+
+    // The scalar kernel is always available and always last
+    double scalar_ns = rows.back().run_ns + rows.back().stab_ns;
+    cout << setw(8) << "kernel" << setw(10) << "edges" << setw(12) << "run ns" << setw(12) << "stab ns"
+         << setw(10) << "speedup" << endl;
+    for (const Row& row : rows) {
+        cout << fixed << setprecision(1) << setw(8) << row.name << setw(10) << edges << setw(12) << row.run_ns
+             << setw(12) << row.stab_ns << setw(9) << scalar_ns / (row.run_ns + row.stab_ns) << "x" << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    PolygonSpec base;
+    int cases = 20;
+    size_t max_pairs = 20000;
+    int edits = 0;
+    size_t kernel_edges = 0;
+    vector<int> vertex_counts;
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        if (arg == "--cases" && a + 1 < argc) cases = atoi(argv[++a]);
+        else if (arg == "--range" && a + 1 < argc) base.coord_range = atoll(argv[++a]);
+        else if (arg == "--concavity" && a + 1 < argc) base.concavity = atof(argv[++a]);
+        else if (arg == "--seed" && a + 1 < argc) base.seed = strtoul(argv[++a], nullptr, 10);
+        else if (arg == "--edits" && a + 1 < argc) edits = atoi(argv[++a]);
+        else if (arg == "--pairs" && a + 1 < argc) max_pairs = strtoull(argv[++a], nullptr, 10);
+        else if (arg == "--kernels" && a + 1 < argc) kernel_edges = strtoull(argv[++a], nullptr, 10);
+        else if (!arg.empty() && isdigit((unsigned char)arg[0])) vertex_counts.push_back(atoi(arg.c_str()));
+        else {
+            cerr << "Usage: " << argv[0]
+                 << " [--cases N] [--range R] [--concavity C] [--seed S] [--pairs P] [--edits N] [--kernels EDGES]"
+                 << " [vertices...]" << endl;
+            return 1;
+        }
+    }
+    if (kernel_edges > 0) {
+        benchKernels(kernel_edges, cases * 1000);
+        return 0;
+    }
+    if (vertex_counts.empty()) vertex_counts = {8, 16, 64, 256, 1024};
+
+    cout << "simd kernels:";
+    for (const string& name : edgeKernelNames()) cout << " " << name;
+    cout << endl;
+
+    cout << setw(8) << "vertices" << setw(5) << "gap" << setw(8) << "cases" << setw(10) << "pairs"
+         << setw(12) << "scan ns" << setw(12) << "index ns" << setw(12) << "grid ns" << setw(12) << "simd ns"
+         << setw(12) << "exact ns" << setw(8) << "strips" << setw(10) << "adjacent" << setw(12) << "mismatches"
+         << endl;
+
+    long long total_mismatches = 0;
+    Repro repro;
+    for (int v : vertex_counts) {
+        for (int gap : {2, 1}) {
+            Totals totals;
+            for (int c = 0; c < cases; ++c) {
+                PolygonSpec spec = base;
+                spec.vertices = v;
+                spec.min_gap = gap;
+                spec.seed = base.seed + c;
+                runCase(spec, max_pairs, totals, repro);
+            }
+            double p = max(1LL, totals.pairs);
+            cout << fixed << setprecision(1) << setw(8) << v << setw(5) << gap << setw(8) << totals.cases
+                 << setw(10) << totals.pairs
+                 << setw(12) << totals.scan_ns / p << setw(12) << totals.index_ns / p
+                 << setw(12) << totals.grid_ns / p << setw(12) << totals.simd_ns / p
+                 << setw(12) << totals.exact_ns / p << setw(8) << totals.strips << setw(10)
+                 << (gap == 1 ? to_string(totals.adjacent) : "-") << setw(12) << totals.mismatches << endl;
+            total_mismatches += totals.mismatches;
+        }
+    }
+    if (repro.found) {
+        const Rect& r = repro.rect;
+        cout << "Smallest adjacent-edge divergence: vertices=" << repro.spec.vertices << " range="
+             << repro.spec.coord_range << " concavity=" << repro.spec.concavity << " seed=" << repro.spec.seed
+             << " (" << repro.points.size() << " red tiles) rect=(" << r.left << "," << r.bottom << ")-("
+             << r.right << "," << r.top << "), polygon in adjacent_repro.txt" << endl;
+        ofstream out("adjacent_repro.txt");
+        for (const Point& p : repro.points) out << p.x << "," << p.y << "\n";
+    }
+
+    if (edits > 0) {
+        // Each size runs once as generated (int32 coordinates) and once
+        // scaled by 2^30, which needs the int64 coordinates and 128-bit areas.
+        cout << endl << setw(8) << "vertices" << setw(8) << "coords" << setw(8) << "edits" << setw(14)
+             << "full ms/edit" << setw(14) << "incr ms/edit" << setw(16) << "checks/edit" << setw(12)
+             << "mismatches" << endl;
+        for (int v : vertex_counts) {
+            for (bool wide : {false, true}) {
+                Totals totals;
+                double full_ms = 0, incr_ms = 0;
+                long long rechecked = 0;
+                for (int c = 0; c < cases; ++c) {
+                    PolygonSpec spec = base;
+                    spec.vertices = v;
+                    spec.seed = base.seed + c;
+                    if (wide) {
+                        runIncrementalCase<int64_t>(spec, 1LL << 30, edits, totals, full_ms, incr_ms, rechecked);
+                    } else {
+                        runIncrementalCase<int32_t>(spec, 1, edits, totals, full_ms, incr_ms, rechecked);
+                    }
+                }
+                double e = max(1, cases * edits);
+                cout << fixed << setprecision(3) << setw(8) << v << setw(8) << (wide ? "int64" : "int32")
+                     << setw(8) << cases * edits << setw(14) << full_ms / e << setw(14) << incr_ms / e
+                     << setw(16) << setprecision(0) << rechecked / e << setw(12) << totals.mismatches << endl;
+                total_mismatches += totals.mismatches;
+            }
+        }
+    }
+
+    return total_mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,386 @@
+#ifndef DAY9_INCREMENTAL_SOLVER_H
+#define DAY9_INCREMENTAL_SOLVER_H
+
+#include <algorithm>
+#include <climits>
+#include <tuple>
+#include <vector>
+
+#include "coord_width.h"
+#include "edge_scan.h"
+
+// Long-lived Day9 part 2 solver for a polygon that changes a few vertices at
+// a time.
+//
+// The sorted edge lists used by isRectangleValidScan are patched in place on
+// every edit instead of being rebuilt.
+//
+// An edit replaces a chain of edges by another chain with the same ends, so
+// the polygon only changes inside the bounding box of the removed and added
+// edges. A rectangle that does not touch that box keeps its validity: no
+// crossing edge can appear or vanish inside it, and the ray-cast parity from
+// its corner only flips for origins enclosed between the old and new chains.
+// Dirty boxes from consecutive edits are merged until the next query().
+//
+// Between queries the solver keeps one invariant: every pair with a larger
+// area than the best valid rectangle is invalid. After an edit, if the best
+// rectangle is untouched (or re-checks as valid) it still counts, and only
+// touched pairs above it can take over. Otherwise the untouched pairs above
+// the old best are still known invalid and everything else is searched
+// largest first.
+//
+// Every invalid pair remembers why: the edge crossing its interior, or the
+// ray from its corner when it lies outside. A touched pair whose reason lies
+// outside the dirty box was not affected by the edit, so it is skipped
+// without a scan. A query is one O(n^2) pass of pair arithmetic plus a
+// handful of containment checks, against a full search's O(n^2) pass plus
+// every check above its running best. That only pays off when the checks
+// dominate, as on input.txt (solution2 --edits); on the fuzz harness's
+// generated polygons the two are level. The crossing_ matrix costs
+// 4 * capacity^2 bytes.
+//
+// Vertices are always held as long long; Coord only picks the area type, so
+// IncrementalSolver<int64_t> gives exact __int128 areas on wide inputs.
+template <typename Coord>
+class IncrementalSolver {
+public:
+    using Area = AreaOf<Coord>;
+
+    explicit IncrementalSolver(const std::vector<Point>& points) {
+        for (const Point& p : points) {
+            xs_.push_back(p.x);
+            ys_.push_back(p.y);
+            slots_.push_back(allocate());
+        }
+        int n = size();
+        for (int k = 0; k < n; ++k) addEdge(vertexAt(k), vertexAt((k + 1) % n));
+    }
+
+    // Every edit keeps the loop rectilinear (though not necessarily simple),
+    // so every edge stays indexed. An edit that would leave a diagonal edge
+    // returns false and changes nothing.
+
+    // Inserts a red tile before loop position pos, on the edge that joins
+    // positions pos - 1 and pos.
+    bool insertCollinearVertex(int pos, Point p) {
+        int n = size();
+        Point prev = vertexAt((pos + n - 1) % n);
+        Point next = vertexAt(pos % n);
+        if (!onSegment(prev, next, p)) return false;
+        spliceIn(pos, p);
+        return true;
+    }
+
+    // Removes the red tile at loop position pos, which must lie on one line
+    // with both of its neighbours.
+    bool removeCollinearVertex(int pos) {
+        int n = size();
+        if (n <= 4) return false;
+        Point here = vertexAt(pos);
+        Point prev = vertexAt((pos + n - 1) % n);
+        Point next = vertexAt((pos + 1) % n);
+        bool same_column = prev.x == here.x && here.x == next.x;
+        bool same_row = prev.y == here.y && here.y == next.y;
+        if (!same_column && !same_row) return false;
+        spliceOut(pos);
+        return true;
+    }
+
+    // Moves the edge between loop positions pos and pos + 1, which must be
+    // vertical with horizontal neighbours, to column x. Both ends keep their
+    // loop positions and rows.
+    bool moveVerticalEdge(int pos, long long x) {
+        int n = size();
+        int a = pos, b = (pos + 1) % n;
+        if (xs_[a] != xs_[b] || ys_[(a + n - 1) % n] != ys_[a] || ys_[b] != ys_[(b + 1) % n]) return false;
+        for (int k : {a, b}) moveVertex(k, {x, ys_[k]});
+        return true;
+    }
+
+    // Moves the edge between loop positions pos and pos + 1, which must be
+    // horizontal with vertical neighbours, to row y.
+    bool moveHorizontalEdge(int pos, long long y) {
+        int n = size();
+        int a = pos, b = (pos + 1) % n;
+        if (ys_[a] != ys_[b] || xs_[(a + n - 1) % n] != xs_[a] || xs_[b] != xs_[(b + 1) % n]) return false;
+        for (int k : {a, b}) moveVertex(k, {xs_[k], y});
+        return true;
+    }
+
+    // Largest valid rectangle area for the current polygon.
+    Area query() {
+        last_rechecked_ = 0;
+        if (!has_dirty_ && has_best_) return best_area_;
+
+        auto touched = [&](long long l, long long b, long long r, long long t) {
+            return has_dirty_ && l <= dr_ && dl_ <= r && b <= dt_ && db_ <= t;
+        };
+        // A touched best rectangle often survives the edit; one check settles it.
+        bool keep_best = has_best_;
+        if (keep_best && touched(best_l_, best_b_, best_r_, best_t_)) {
+            last_rechecked_++;
+            keep_best = bestPairExists() &&
+                        isRectangleValidScan(edges_, best_l_, best_b_, best_r_, best_t_);
+        }
+        Area old_best = has_best_ ? best_area_ : 0;
+
+        // Pairs that may be valid and larger than anything known to be valid.
+        std::vector<std::tuple<Area, int, int>> heap;
+        int n = size();
+        for (int i = 0; i < n; ++i) {
+            int* row = &crossing_[(size_t)slots_[i] * capacity_];
+            for (int j = i + 1; j < n; ++j) {
+                long long l = std::min(xs_[i], xs_[j]), r = std::max(xs_[i], xs_[j]);
+                long long b = std::min(ys_[i], ys_[j]), t = std::max(ys_[i], ys_[j]);
+                Area area = ((Area)r - l + 1) * ((Area)t - b + 1);
+                bool hit = touched(l, b, r, t);
+                // Untouched pairs keep their validity; those above the old
+                // best are invalid, and a kept best already beats the rest.
+                if (!hit && has_best_ && (keep_best || area > old_best)) continue;
+                if (keep_best && area <= old_best) continue;
+                int w = row[slots_[j]];
+                if (w >= 0) {
+                    const Witness& e = witnesses_[w];
+                    if (!hit || !touched(e.l, e.b, e.r, e.t)) continue;
+                    setCrossing(slots_[i], slots_[j], -1);
+                }
+                heap.push_back({area, i, j});
+            }
+        }
+        has_dirty_ = false;
+        if (!keep_best) has_best_ = false, best_area_ = 0;
+
+        std::make_heap(heap.begin(), heap.end());
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end());
+            auto [area, i, j] = heap.back();
+            heap.pop_back();
+            long long l = std::min(xs_[i], xs_[j]), r = std::max(xs_[i], xs_[j]);
+            long long b = std::min(ys_[i], ys_[j]), t = std::max(ys_[i], ys_[j]);
+            if (isPairValid(slots_[i], slots_[j], l, b, r, t)) {
+                has_best_ = true;
+                best_area_ = area;
+                best_l_ = l, best_b_ = b, best_r_ = r, best_t_ = t;
+                break;
+            }
+        }
+        if (witnesses_.size() > (size_t)n * n + 1024) compactWitnesses();
+        return best_area_;
+    }
+
+    int size() const { return xs_.size(); }
+    Point vertexAt(int pos) const { return {xs_[pos], ys_[pos]}; }
+    std::vector<Point> points() const {
+        std::vector<Point> out;
+        for (int k = 0; k < size(); ++k) out.push_back(vertexAt(k));
+        return out;
+    }
+
+    // Containment checks run by the most recent query().
+    long long lastRechecked() const { return last_rechecked_; }
+
+private:
+    // Bounding box of what made a pair invalid: an edge crossing its
+    // rectangle, or the ray cast from its corner when it lies outside.
+    struct Witness {
+        long long l, b, r, t;
+    };
+
+    static bool onSegment(const Point& a, const Point& b, const Point& p) {
+        if (a.x == b.x && p.x == a.x) return std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y);
+        if (a.y == b.y && p.y == a.y) return std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x);
+        return false;
+    }
+
+    // Splices a red tile into the loop before position pos. The public edits
+    // only call this where the new edges stay axis-aligned.
+    void spliceIn(int pos, Point p) {
+        int n = size();
+        Point prev = vertexAt((pos + n - 1) % n);
+        Point next = vertexAt(pos % n);
+        removeEdge(prev, next);
+        addEdge(prev, p);
+        addEdge(p, next);
+        xs_.insert(xs_.begin() + pos, p.x);
+        ys_.insert(ys_.begin() + pos, p.y);
+        slots_.insert(slots_.begin() + pos, allocate());
+    }
+
+    void spliceOut(int pos) {
+        int n = size();
+        Point here = vertexAt(pos);
+        Point prev = vertexAt((pos + n - 1) % n);
+        Point next = vertexAt((pos + 1) % n);
+        removeEdge(prev, here);
+        removeEdge(here, next);
+        addEdge(prev, next);
+        free_slots_.push_back(slots_[pos]);
+        xs_.erase(xs_.begin() + pos);
+        ys_.erase(ys_.begin() + pos);
+        slots_.erase(slots_.begin() + pos);
+    }
+
+    // A moved tile is a new red tile: its pairs start with no witnesses.
+    void moveVertex(int pos, Point p) {
+        spliceOut(pos);
+        spliceIn(pos, p);
+    }
+
+    // Slots of removed vertices are reused; a new slot starts with no
+    // crossing edges recorded. The matrix doubles when it runs out of slots.
+    int allocate() {
+        int slot;
+        if (!free_slots_.empty()) {
+            slot = free_slots_.back();
+            free_slots_.pop_back();
+        } else {
+            slot = used_slots_++;
+            if (slot >= capacity_) {
+                int grown = std::max(64, 2 * capacity_);
+                std::vector<int> next((size_t)grown * grown, -1);
+                for (int r = 0; r < capacity_; ++r)
+                    std::copy(crossing_.begin() + (size_t)r * capacity_,
+                              crossing_.begin() + (size_t)(r + 1) * capacity_,
+                              next.begin() + (size_t)r * grown);
+                crossing_.swap(next);
+                capacity_ = grown;
+            }
+        }
+        for (int k = 0; k < capacity_; ++k) setCrossing(slot, k, -1);
+        return slot;
+    }
+
+    void setCrossing(int u, int v, int w) {
+        crossing_[(size_t)u * capacity_ + v] = w;
+        crossing_[(size_t)v * capacity_ + u] = w;
+    }
+
+    // isRectangleValidScan, recording the crossing edge that rejects a pair.
+    bool isPairValid(int u, int v, long long l, long long b, long long r, long long t) {
+        last_rechecked_++;
+        auto it_v = std::upper_bound(edges_.v_edges.begin(), edges_.v_edges.end(), l,
+            [](long long val, const VEdge& e) { return val < e.x; });
+        for (; it_v != edges_.v_edges.end() && it_v->x < r; ++it_v) {
+            if (it_v->y_min < t && it_v->y_max > b) {
+                setCrossing(u, v, witnesses_.size());
+                witnesses_.push_back({it_v->x, it_v->y_min, it_v->x, it_v->y_max});
+                return false;
+            }
+        }
+        auto it_h = std::upper_bound(edges_.h_edges.begin(), edges_.h_edges.end(), b,
+            [](long long val, const HEdge& e) { return val < e.y; });
+        for (; it_h != edges_.h_edges.end() && it_h->y < t; ++it_h) {
+            if (it_h->x_min < r && it_h->x_max > l) {
+                setCrossing(u, v, witnesses_.size());
+                witnesses_.push_back({it_h->x_min, it_h->y, it_h->x_max, it_h->y});
+                return false;
+            }
+        }
+        if (isRectangleValidScan(edges_, l, b, r, t)) return true;
+        // Nothing crosses it, so it lies outside; only an edit on the ray
+        // from its corner can change that.
+        setCrossing(u, v, witnesses_.size());
+        witnesses_.push_back({r, b, LLONG_MAX, b});
+        return false;
+    }
+
+    // Drop witnesses that no live pair refers to any more.
+    void compactWitnesses() {
+        std::vector<Witness> kept;
+        int n = size();
+        for (int i = 0; i < n; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                int w = crossing_[(size_t)slots_[i] * capacity_ + slots_[j]];
+                if (w < 0) continue;
+                setCrossing(slots_[i], slots_[j], kept.size());
+                kept.push_back(witnesses_[w]);
+            }
+        }
+        witnesses_.swap(kept);
+    }
+
+    // Whether two red tiles still sit on opposite corners of the best rectangle.
+    bool bestPairExists() const {
+        bool lb = false, rt = false, lt = false, rb = false;
+        for (int k = 0; k < size(); ++k) {
+            lb |= xs_[k] == best_l_ && ys_[k] == best_b_;
+            rt |= xs_[k] == best_r_ && ys_[k] == best_t_;
+            lt |= xs_[k] == best_l_ && ys_[k] == best_t_;
+            rb |= xs_[k] == best_r_ && ys_[k] == best_b_;
+        }
+        return (lb && rt) || (lt && rb);
+    }
+
+    void markDirty(const Point& a, const Point& b) {
+        long long l = std::min(a.x, b.x), r = std::max(a.x, b.x);
+        long long lo = std::min(a.y, b.y), hi = std::max(a.y, b.y);
+        if (!has_dirty_) {
+            dl_ = l, dr_ = r, db_ = lo, dt_ = hi;
+            has_dirty_ = true;
+        } else {
+            dl_ = std::min(dl_, l), dr_ = std::max(dr_, r);
+            db_ = std::min(db_, lo), dt_ = std::max(dt_, hi);
+        }
+    }
+
+    // Same classification as buildEdges. A diagonal edge only exists inside
+    // spliceOut/spliceIn while a vertex moves, and is removed again before
+    // the edit returns, so it is never indexed.
+    void addEdge(const Point& a, const Point& b) {
+        markDirty(a, b);
+        if (a.x == b.x) {
+            VEdge e{a.x, std::min(a.y, b.y), std::max(a.y, b.y)};
+            auto it = std::upper_bound(edges_.v_edges.begin(), edges_.v_edges.end(), e.x,
+                [](long long val, const VEdge& v) { return val < v.x; });
+            edges_.v_edges.insert(it, e);
+        } else if (a.y == b.y) {
+            HEdge e{a.y, std::min(a.x, b.x), std::max(a.x, b.x)};
+            auto it = std::upper_bound(edges_.h_edges.begin(), edges_.h_edges.end(), e.y,
+                [](long long val, const HEdge& h) { return val < h.y; });
+            edges_.h_edges.insert(it, e);
+        }
+    }
+
+    void removeEdge(const Point& a, const Point& b) {
+        markDirty(a, b);
+        if (a.x == b.x) {
+            long long lo = std::min(a.y, b.y), hi = std::max(a.y, b.y);
+            auto it = std::lower_bound(edges_.v_edges.begin(), edges_.v_edges.end(), a.x,
+                [](const VEdge& v, long long val) { return v.x < val; });
+            for (; it != edges_.v_edges.end() && it->x == a.x; ++it) {
+                if (it->y_min == lo && it->y_max == hi) {
+                    edges_.v_edges.erase(it);
+                    return;
+                }
+            }
+        } else if (a.y == b.y) {
+            long long lo = std::min(a.x, b.x), hi = std::max(a.x, b.x);
+            auto it = std::lower_bound(edges_.h_edges.begin(), edges_.h_edges.end(), a.y,
+                [](const HEdge& h, long long val) { return h.y < val; });
+            for (; it != edges_.h_edges.end() && it->y == a.y; ++it) {
+                if (it->x_min == lo && it->x_max == hi) {
+                    edges_.h_edges.erase(it);
+                    return;
+                }
+            }
+        }
+    }
+
+    std::vector<long long> xs_, ys_;    // red tiles in boundary order
+    std::vector<int> slots_;            // crossing_ row of each red tile
+    std::vector<int> free_slots_;
+    int used_slots_ = 0, capacity_ = 0;
+    std::vector<int> crossing_;         // capacity_ x capacity_ witness index, -1 if none
+    std::vector<Witness> witnesses_;
+    EdgeLists edges_;
+
+    bool has_best_ = false;
+    Area best_area_ = 0;
+    long long best_l_ = 0, best_b_ = 0, best_r_ = 0, best_t_ = 0;
+
+    bool has_dirty_ = false;
+    long long dl_ = 0, db_ = 0, dr_ = 0, dt_ = 0;
+    long long last_rechecked_ = 0;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef DAY9_PERF_COUNTER_H
+#define DAY9_PERF_COUNTER_H
+
+#include <cstdint>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// One hardware event counted for the calling thread via perf_event_open.
+// Kernels that forbid it (perf_event_paranoid, containers, VMs without a
+// PMU) leave the counter unavailable and read() returns -1.
+class PerfCounter {
+public:
+    PerfCounter(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = type;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    ~PerfCounter() {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    void stop() {
+        if (fd_ >= 0) ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    long long read() const {
+        uint64_t value = 0;
+        if (fd_ < 0 || ::read(fd_, &value, sizeof(value)) != (ssize_t)sizeof(value)) return -1;
+        return (long long)value;
+    }
+
+    // L1 data cache read misses and last-level cache misses.
+    static PerfCounter l1dMisses() {
+        return PerfCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    }
+    static PerfCounter cacheMisses() { return PerfCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES); }
+
+private:
+    int fd_ = -1;
+};
+
+#endif
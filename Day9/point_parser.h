@@ -0,0 +1,142 @@
+#ifndef DAY9_POINT_PARSER_H
+#define DAY9_POINT_PARSER_H
+
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Red tiles as two coordinate columns.
+struct PointBuffer {
+    std::vector<long long> xs, ys;
+
+    size_t size() const { return xs.size(); }
+};
+
+struct ParseStats {
+    size_t bytes = 0;
+    size_t lines = 0;
+    size_t invalid = 0;
+    double ms = 0;
+
+    double bytesPerSecond() const { return ms > 0 ? bytes / (ms / 1000.0) : 0; }
+};
+
+// Parses exactly `count` integers from [p, end), e.g. an "x,y" line. Numbers
+// are separated by a comma or whitespace, with optional spaces around them.
+inline bool parseIntegerLine(const char* p, const char* end, long long* out, int count) {
+    auto skipBlanks = [&]() {
+        while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    };
+    skipBlanks();
+    for (int k = 0; k < count; ++k) {
+        if (k > 0) {
+            const char* number_end = p;
+            skipBlanks();
+            if (p < end && *p == ',') ++p;
+            if (p == number_end) return false;
+            skipBlanks();
+        }
+        auto r = std::from_chars(p, end, out[k]);
+        if (r.ec != std::errc()) return false;
+        p = r.ptr;
+    }
+    skipBlanks();
+    return p == end;
+}
+
+inline bool parsePointLine(const char* p, const char* end, long long& x, long long& y) {
+    long long xy[2];
+    if (!parseIntegerLine(p, end, xy, 2)) return false;
+    x = xy[0];
+    y = xy[1];
+    return true;
+}
+
+// Maps `filename` and parses every non-empty line into `out`, which is
+// reserved up front from the newline count. Malformed lines are reported as
+// "Invalid line: ..." on stderr and skipped. Returns false if the file cannot
+// be opened or mapped.
+inline bool parsePointFile(const std::string& filename, PointBuffer& out, ParseStats* stats = nullptr) {
+    auto start = std::chrono::steady_clock::now();
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error: Could not open " << filename << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error: Could not open " << filename << std::endl;
+        close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    const char* data = nullptr;
+    if (size > 0) {
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            std::cerr << "Error: Could not map " << filename << std::endl;
+            close(fd);
+            return false;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<const char*>(mapped);
+    }
+    close(fd);
+
+    const char* end = data + size;
+    size_t lines = 0;
+    for (const char* p = data; p < end; ++lines) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        p = nl ? nl + 1 : end;
+    }
+    out.xs.clear();
+    out.ys.clear();
+    out.xs.reserve(lines);
+    out.ys.reserve(lines);
+
+    size_t invalid = 0;
+    for (const char* p = data; p < end;) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* line_end = nl ? nl : end;
+        const char* content_end = line_end;
+        if (content_end > p && content_end[-1] == '\r') --content_end;
+        if (content_end > p) {
+            long long x, y;
+            if (parsePointLine(p, content_end, x, y)) {
+                out.xs.push_back(x);
+                out.ys.push_back(y);
+            } else {
+                std::cerr << "Invalid line: " << std::string(p, content_end) << std::endl;
+                invalid++;
+            }
+        }
+        p = nl ? nl + 1 : end;
+    }
+
+    if (size > 0) munmap(const_cast<char*>(data), size);
+    if (stats) {
+        stats->bytes = size;
+        stats->lines = lines;
+        stats->invalid = invalid;
+        stats->ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return true;
+}
+
+// One-line throughput summary for stderr.
+inline void reportParse(const ParseStats& stats, size_t points) {
+    std::cerr << "Parsed " << points << " points (" << stats.bytes << " bytes) in " << stats.ms
+              << " ms, " << stats.bytesPerSecond() / 1e6 << " MB/s";
+    if (stats.invalid) std::cerr << ", " << stats.invalid << " invalid lines";
+    std::cerr << std::endl;
+}
+
+#endif
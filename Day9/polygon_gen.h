@@ -0,0 +1,177 @@
+#ifndef DAY9_POLYGON_GEN_H
+#define DAY9_POLYGON_GEN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+struct PolygonSpec {
+    int vertices = 16;          // minimum number of red tiles (corners)
+    long long coord_range = 100000;
+    double concavity = 0.5;     // 0 = blobby, 1 = long thin arms
+    int min_gap = 2;            // 1 puts some parallel edges on adjacent tiles
+    uint32_t seed = 1;
+};
+
+// Random simple rectilinear polygon, returned as red tiles in boundary order.
+//
+// A polyomino is grown cell by cell on a small lattice. Growth is rejected if
+// it would make two cells touch only at a corner, which keeps the boundary a
+// single simple loop; enclosed holes are filled at the end. Low concavity
+// favours frontier cells with several filled neighbours, high concavity lets
+// single-neighbour cells through and so grows arms. The boundary corners are
+// then mapped to random increasing coordinates in [0, coord_range], which
+// produces anything from nearly touching (gap min_gap) to very distant edges.
+inline std::vector<std::pair<long long, long long>> generatePolygon(const PolygonSpec& spec) {
+    std::mt19937 rng(spec.seed);
+    int g = std::max(4, spec.vertices);
+    auto inGrid = [&](int r, int c) { return r >= 0 && r < g && c >= 0 && c < g; };
+
+    std::vector<std::vector<char>> filled(g, std::vector<char>(g, 0));
+    auto isFilled = [&](int r, int c) { return inGrid(r, c) && filled[r][c]; };
+
+    // Lattice point (r, c) is the corner shared by cells (r-1..r, c-1..c).
+    auto cornerKind = [&](int r, int c) {
+        bool a = isFilled(r - 1, c - 1), b = isFilled(r - 1, c);
+        bool d = isFilled(r, c - 1), e = isFilled(r, c);
+        int count = a + b + d + e;
+        if (count == 2 && a == e) return 2;   // diagonal touch
+        return (count == 1 || count == 3) ? 1 : 0;
+    };
+
+    filled[g / 2][g / 2] = 1;
+    int corners = 4;
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const int dr[4] = {1, -1, 0, 0};
+    const int dc[4] = {0, 0, 1, -1};
+
+    // Candidate cells next to the polyomino; entries may go stale and are
+    // dropped when picked.
+    std::vector<std::pair<int, int>> frontier;
+    auto pushNeighbours = [&](int r, int c) {
+        for (int d = 0; d < 4; ++d)
+            if (inGrid(r + dr[d], c + dc[d]) && !filled[r + dr[d]][c + dc[d]])
+                frontier.push_back({r + dr[d], c + dc[d]});
+    };
+    pushNeighbours(g / 2, g / 2);
+
+    for (long long attempt = 0; corners < spec.vertices && !frontier.empty() &&
+                                attempt < 1000LL * spec.vertices; ++attempt) {
+        size_t k = std::uniform_int_distribution<size_t>(0, frontier.size() - 1)(rng);
+        auto [r, c] = frontier[k];
+        if (filled[r][c]) {
+            frontier[k] = frontier.back();
+            frontier.pop_back();
+            continue;
+        }
+        int neighbours = 0;
+        for (int d = 0; d < 4; ++d) neighbours += isFilled(r + dr[d], c + dc[d]);
+        if (neighbours == 0) continue;
+        double accept = neighbours >= 2 ? 1.0 - 0.9 * spec.concavity : 0.1 + 0.9 * spec.concavity;
+        if (unit(rng) > accept) continue;
+
+        int before = 0;
+        for (int pr = r; pr <= r + 1; ++pr)
+            for (int pc = c; pc <= c + 1; ++pc)
+                before += cornerKind(pr, pc) == 1;
+        filled[r][c] = 1;
+        int after = 0;
+        bool diagonal = false;
+        for (int pr = r; pr <= r + 1; ++pr) {
+            for (int pc = c; pc <= c + 1; ++pc) {
+                int kind = cornerKind(pr, pc);
+                after += kind == 1;
+                diagonal |= kind == 2;
+            }
+        }
+        if (diagonal) {
+            filled[r][c] = 0;
+            continue;
+        }
+        corners += after - before;
+        pushNeighbours(r, c);
+    }
+
+    // Fill holes: anything not reachable from outside the lattice.
+    std::vector<std::vector<char>> outside(g + 2, std::vector<char>(g + 2, 0));
+    std::vector<std::pair<int, int>> stack = {{0, 0}};
+    outside[0][0] = 1;
+    while (!stack.empty()) {
+        auto [r, c] = stack.back();
+        stack.pop_back();
+        for (int d = 0; d < 4; ++d) {
+            int nr = r + dr[d], nc = c + dc[d];
+            if (nr < 0 || nr > g + 1 || nc < 0 || nc > g + 1 || outside[nr][nc]) continue;
+            if (inGrid(nr - 1, nc - 1) && filled[nr - 1][nc - 1]) continue;
+            outside[nr][nc] = 1;
+            stack.push_back({nr, nc});
+        }
+    }
+    for (int r = 0; r < g; ++r)
+        for (int c = 0; c < g; ++c)
+            if (!outside[r + 1][c + 1]) filled[r][c] = 1;
+
+    // Directed unit boundary edges with the polygon on the left; with no
+    // diagonal touches every lattice point has at most one outgoing edge.
+    std::map<std::pair<int, int>, std::pair<int, int>> next;
+    for (int r = 0; r < g; ++r) {
+        for (int c = 0; c < g; ++c) {
+            if (!filled[r][c]) continue;
+            // Lattice points as (x, y) = (c, r); cell spans [c, c+1] x [r, r+1].
+            if (!isFilled(r - 1, c)) next[{c, r}] = {c + 1, r};
+            if (!isFilled(r, c + 1)) next[{c + 1, r}] = {c + 1, r + 1};
+            if (!isFilled(r + 1, c)) next[{c + 1, r + 1}] = {c, r + 1};
+            if (!isFilled(r, c - 1)) next[{c, r + 1}] = {c, r};
+        }
+    }
+
+    std::vector<std::pair<int, int>> loop;
+    std::pair<int, int> start = next.begin()->first, cur = start;
+    do {
+        loop.push_back(cur);
+        cur = next[cur];
+    } while (cur != start);
+
+    std::vector<std::pair<int, int>> lattice;
+    int m = loop.size();
+    for (int k = 0; k < m; ++k) {
+        auto prev = loop[(k + m - 1) % m], here = loop[k], after = loop[(k + 1) % m];
+        bool straight = (prev.first == here.first && here.first == after.first) ||
+                        (prev.second == here.second && here.second == after.second);
+        if (!straight) lattice.push_back(here);
+    }
+
+    // Stretch the lattice onto random increasing coordinates, at least 2
+    // apart by default. A gap of 1 puts two parallel edges on adjacent tiles
+    // with an empty sliver of "outside" between them that contains no tile,
+    // where the tile rules and the engines' continuous geometry differ; with
+    // min_gap 1 about half of the gaps are 1, to provoke exactly that.
+    long long range = std::max<long long>(spec.coord_range, 3LL * g);
+    auto axis = [&]() {
+        std::vector<long long> values;
+        if (spec.min_gap <= 1) {
+            std::uniform_int_distribution<long long> step(2, std::max(2LL, range / (g + 1)));
+            long long v = 0;
+            for (int k = 0; k <= g; ++k, v += unit(rng) < 0.5 ? 1 : step(rng)) values.push_back(v);
+            return values;
+        }
+        std::set<long long> picks;
+        std::uniform_int_distribution<long long> coord(0, range - 2LL * g);
+        while ((int)picks.size() < g + 1) picks.insert(coord(rng));
+        values.assign(picks.begin(), picks.end());
+        for (int k = 0; k <= g; ++k) values[k] += k;
+        return values;
+    };
+    std::vector<long long> xs = axis(), ys = axis();
+
+    std::vector<std::pair<long long, long long>> reds;
+    reds.reserve(lattice.size());
+    for (auto& p : lattice) reds.push_back({xs[p.first], ys[p.second]});
+    return reds;
+}
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef DAY9_POLYGON_INDEX_H
+#define DAY9_POLYGON_INDEX_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// An axis-parallel polygon edge: fixed coordinate `key`, spanning [lo, hi]
+// along the other axis. Vertical edges use key = x, horizontal key = y.
+struct AxisSegment {
+    long long key;
+    long long lo, hi;
+};
+
+// Merge-sort tree over segments sorted by key. Every node keeps its segments
+// sorted by lo (with a running max of hi) and its hi values sorted, which
+// answers both queries below in O(log^2 n) with O(n log n) memory.
+class SegmentIndex {
+public:
+    SegmentIndex() = default;
+
+    explicit SegmentIndex(std::vector<AxisSegment> segs) : segs_(std::move(segs)) {
+        std::sort(segs_.begin(), segs_.end(), [](const AxisSegment& a, const AxisSegment& b) {
+            return a.key < b.key;
+        });
+        keys_.reserve(segs_.size());
+        for (const AxisSegment& s : segs_) keys_.push_back(s.key);
+        if (!segs_.empty()) {
+            nodes_.resize(4 * segs_.size());
+            build(1, 0, (int)segs_.size());
+        }
+    }
+
+    // Is there a segment with key_lo < key < key_hi whose span overlaps the
+    // open interval (lo, hi)?
+    bool anyCrossing(long long key_lo, long long key_hi, long long lo, long long hi) const {
+        int a = (int)(std::upper_bound(keys_.begin(), keys_.end(), key_lo) - keys_.begin());
+        int b = (int)(std::lower_bound(keys_.begin(), keys_.end(), key_hi) - keys_.begin());
+        if (a >= b) return false;
+        return crossing(1, 0, (int)segs_.size(), a, b, lo, hi);
+    }
+
+    // Number of segments with key >= key_from and lo <= at < hi.
+    int countStabbing(long long key_from, long long at) const {
+        int a = (int)(std::lower_bound(keys_.begin(), keys_.end(), key_from) - keys_.begin());
+        if (a >= (int)segs_.size()) return 0;
+        return stabbing(1, 0, (int)segs_.size(), a, (int)segs_.size(), at);
+    }
+
+    const std::vector<AxisSegment>& segments() const { return segs_; }
+
+private:
+    struct Node {
+        std::vector<long long> los;      // lo values, ascending
+        std::vector<long long> max_hi;   // max hi over los[0..i]
+        std::vector<long long> his;      // hi values, ascending
+    };
+
+    void build(int node, int l, int r) {
+        Node& nd = nodes_[node];
+        std::vector<std::pair<long long, long long>> spans;
+        spans.reserve(r - l);
+        for (int i = l; i < r; ++i) {
+            spans.push_back({segs_[i].lo, segs_[i].hi});
+            nd.his.push_back(segs_[i].hi);
+        }
+        std::sort(spans.begin(), spans.end());
+        std::sort(nd.his.begin(), nd.his.end());
+        long long running = spans[0].second;
+        for (const auto& s : spans) {
+            running = std::max(running, s.second);
+            nd.los.push_back(s.first);
+            nd.max_hi.push_back(running);
+        }
+        if (r - l == 1) return;
+        int m = (l + r) / 2;
+        build(2 * node, l, m);
+        build(2 * node + 1, m, r);
+    }
+
+    bool crossing(int node, int l, int r, int a, int b, long long lo, long long hi) const {
+        if (b <= l || r <= a) return false;
+        if (a <= l && r <= b) {
+            const Node& nd = nodes_[node];
+            int k = (int)(std::lower_bound(nd.los.begin(), nd.los.end(), hi) - nd.los.begin());
+            return k > 0 && nd.max_hi[k - 1] > lo;
+        }
+        int m = (l + r) / 2;
+        return crossing(2 * node, l, m, a, b, lo, hi) || crossing(2 * node + 1, m, r, a, b, lo, hi);
+    }
+
+    int stabbing(int node, int l, int r, int a, int b, long long at) const {
+        if (b <= l || r <= a) return 0;
+        if (a <= l && r <= b) {
+            const Node& nd = nodes_[node];
+            // lo <= at < hi  ==  (lo <= at) minus (hi <= at), since lo < hi.
+            int started = (int)(std::upper_bound(nd.los.begin(), nd.los.end(), at) - nd.los.begin());
+            int ended = (int)(std::upper_bound(nd.his.begin(), nd.his.end(), at) - nd.his.begin());
+            return started - ended;
+        }
+        int m = (l + r) / 2;
+        return stabbing(2 * node, l, m, a, b, at) + stabbing(2 * node + 1, m, r, a, b, at);
+    }
+
+    std::vector<AxisSegment> segs_;
+    std::vector<long long> keys_;
+    std::vector<Node> nodes_;
+};
+
+// Both edge sets of a rectilinear polygon, indexed for rectangle queries.
+class PolygonIndex {
+public:
+    PolygonIndex() = default;
+
+    template <typename PointT>
+    explicit PolygonIndex(const std::vector<PointT>& points) {
+        std::vector<AxisSegment> v, h;
+        int n = points.size();
+        for (int i = 0; i < n; ++i) {
+            const PointT& p1 = points[i];
+            const PointT& p2 = points[(i + 1) % n];
+            if (p1.x == p2.x) {
+                v.push_back({p1.x, std::min(p1.y, p2.y), std::max(p1.y, p2.y)});
+            } else if (p1.y == p2.y) {
+                h.push_back({p1.y, std::min(p1.x, p2.x), std::max(p1.x, p2.x)});
+            }
+        }
+        vertical_ = SegmentIndex(std::move(v));
+        horizontal_ = SegmentIndex(std::move(h));
+    }
+
+    // Does any polygon edge pass through the open rectangle?
+    bool crossesOpenRect(long long left, long long bottom, long long right, long long top) const {
+        return vertical_.anyCrossing(left, right, bottom, top) ||
+               horizontal_.anyCrossing(bottom, top, left, right);
+    }
+
+    // Ray cast from (x, y + 0.5) towards +x: odd crossings means the unit row
+    // just above y is inside the polygon at x.
+    bool isInside(long long x, long long y) const {
+        return vertical_.countStabbing(x, y) % 2 != 0;
+    }
+
+    // A rectangle with red corners is valid when no edge cuts its interior and
+    // its interior (or degenerate strip) lies inside the polygon.
+    bool isRectangleValid(long long left, long long bottom, long long right, long long top) const {
+        return !crossesOpenRect(left, bottom, right, top) && isInside(right, bottom);
+    }
+
+private:
+    SegmentIndex vertical_;
+    SegmentIndex horizontal_;
+};
+
+#endif
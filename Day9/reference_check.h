@@ -0,0 +1,149 @@
+#ifndef DAY9_REFERENCE_CHECK_H
+#define DAY9_REFERENCE_CHECK_H
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Reference containment checks on the raw red-tile list, kept independent of
+// the solver data structures so they can serve as an oracle.
+
+inline bool isOnBoundary(long long testx, long long testy, const std::vector<std::pair<long long, long long>>& reds) {
+    int n = reds.size();
+    for (int i = 0; i < n; ++i) {
+        int j = (i + 1) % n;
+        long long x1 = reds[i].first, y1 = reds[i].second;
+        long long x2 = reds[j].first, y2 = reds[j].second;
+
+        if (x1 == x2) {
+            // Vertical line
+            if (testx == x1 && testy >= std::min(y1, y2) && testy <= std::max(y1, y2)) {
+                return true;
+            }
+        } else if (y1 == y2) {
+            // Horizontal line
+            if (testy == y1 && testx >= std::min(x1, x2) && testx <= std::max(x1, x2)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+inline bool isInsidePolygon(long long testx, long long testy, const std::vector<std::pair<long long, long long>>& reds) {
+    int n = reds.size();
+    int winding = 0;
+
+    for (int i = 0; i < n; ++i) {
+        int j = (i + 1) % n;
+        long long x1 = reds[i].first, y1 = reds[i].second;
+        long long y2 = reds[j].second;
+
+        // Only vertical edges can straddle testy, so the crossing is at x1.
+        if ((y1 <= testy && y2 > testy) || (y1 > testy && y2 <= testy)) {
+            if (x1 > testx) {
+                winding++;
+            }
+        }
+    }
+
+    return (winding % 2) == 1;
+}
+
+inline bool isValidTile(long long x, long long y, const std::vector<std::pair<long long, long long>>& reds) {
+    // Check if it's a red tile
+    for (auto& p : reds) {
+        if (p.first == x && p.second == y) return true;
+    }
+
+    // Check if it's on boundary or inside
+    return isOnBoundary(x, y, reds) || isInsidePolygon(x, y, reds);
+}
+
+inline bool isRectangleValidByTiles(long long x1, long long y1, long long x2, long long y2,
+                                    const std::vector<std::pair<long long, long long>>& reds) {
+    // Check all points on the rectangle boundary, one tile at a time.
+    // O(perimeter * n): only usable on small coordinates.
+    // Top edge
+    for (long long x = x1; x <= x2; ++x) {
+        if (!isValidTile(x, y1, reds)) return false;
+    }
+    // Bottom edge
+    for (long long x = x1; x <= x2; ++x) {
+        if (!isValidTile(x, y2, reds)) return false;
+    }
+    // Left edge (excluding corners already checked)
+    for (long long y = y1 + 1; y < y2; ++y) {
+        if (!isValidTile(x1, y, reds)) return false;
+    }
+    // Right edge (excluding corners already checked)
+    for (long long y = y1 + 1; y < y2; ++y) {
+        if (!isValidTile(x2, y, reds)) return false;
+    }
+
+    return true;
+}
+
+using Run = std::pair<long long, long long>;
+
+// Red/green tiles on row y as sorted, disjoint, non-adjacent closed runs.
+// Interior runs come from the vertical edges straddling y + 0.5 paired up
+// left to right; boundary tiles come from horizontal edges on y and from
+// vertical edges ending on y. O(n log n), independent of coordinate size.
+inline std::vector<Run> rowRuns(long long y, const std::vector<std::pair<long long, long long>>& reds) {
+    int n = reds.size();
+    std::vector<long long> crossings;
+    std::vector<Run> runs;
+    for (int i = 0; i < n; ++i) {
+        int j = (i + 1) % n;
+        long long x1 = reds[i].first, y1 = reds[i].second;
+        long long x2 = reds[j].first, y2 = reds[j].second;
+        if (x1 == x2) {
+            long long lo = std::min(y1, y2), hi = std::max(y1, y2);
+            if (lo <= y && y < hi) crossings.push_back(x1);
+            else if (y == hi) runs.push_back({x1, x1});
+        } else if (y1 == y && y2 == y) {
+            runs.push_back({std::min(x1, x2), std::max(x1, x2)});
+        }
+    }
+    std::sort(crossings.begin(), crossings.end());
+    for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+        runs.push_back({crossings[k], crossings[k + 1]});
+    }
+
+    std::sort(runs.begin(), runs.end());
+    std::vector<Run> merged;
+    for (const Run& r : runs) {
+        if (!merged.empty() && r.first <= merged.back().second + 1) {
+            merged.back().second = std::max(merged.back().second, r.second);
+        } else {
+            merged.push_back(r);
+        }
+    }
+    return merged;
+}
+
+inline bool runsCover(const std::vector<Run>& runs, long long from, long long to) {
+    auto it = std::upper_bound(runs.begin(), runs.end(), Run{from, std::numeric_limits<long long>::max()});
+    if (it == runs.begin()) return false;
+    --it;
+    return it->first <= from && to <= it->second;
+}
+
+// Exact, integer-only equivalent of isRectangleValidByTiles: each side of the
+// rectangle must lie within a single run of red/green tiles. Columns reuse
+// rowRuns on the transposed polygon.
+inline bool isRectangleValid(long long x1, long long y1, long long x2, long long y2,
+                             const std::vector<std::pair<long long, long long>>& reds) {
+    std::vector<std::pair<long long, long long>> transposed;
+    transposed.reserve(reds.size());
+    for (auto& p : reds) transposed.push_back({p.second, p.first});
+
+    return runsCover(rowRuns(y1, reds), x1, x2) &&
+           runsCover(rowRuns(y2, reds), x1, x2) &&
+           runsCover(rowRuns(x1, transposed), y1, y2) &&
+           runsCover(rowRuns(x2, transposed), y1, y2);
+}
+
+#endif
@@ -1,48 +1,131 @@
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
-#include <sstream>
 #include <cstdlib>
 #include <algorithm>
+#include <chrono>
+#include <random>
+
+#include "perf_counter.h"
+#include "point_parser.h"
+#include "staircase.h"
 
 using namespace std;
 
-int main() {
-    ifstream infile("input.txt");
-    if (!infile) {
-        cerr << "Error opening input.txt" << endl;
-        return 1;
-    }
+// Compare the staircase engine against the pair loop on random point sets,
+// and the int32 layout against the int64 one.
+// The pair loop is skipped above 100k points; at 1M it would need 5e11 pairs.
+void runBenchmark() {
+    mt19937 rng(2025);
+    uniform_int_distribution<int> coord(0, 100000);
+    for (size_t n : {1000, 100000, 1000000}) {
+        vector<pair<int, int>> points(n);
+        for (auto& p : points) p = {coord(rng), coord(rng)};
+
+        auto t0 = chrono::steady_clock::now();
+        long long fast = staircaseMaxArea(points);
+        auto t1 = chrono::steady_clock::now();
+        double fast_ms = chrono::duration<double, milli>(t1 - t0).count();
 
-    vector<pair<int, int>> points;
-    string line;
-    while (getline(infile, line)) {
-        if (line.empty()) continue;
-        stringstream ss(line);
-        int x, y;
-        char comma;
-        ss >> x >> comma >> y;
-        if (ss.fail()) {
-            cerr << "Invalid line: " << line << endl;
-            continue;
+        vector<pair<int64_t, int64_t>> wide(points.begin(), points.end());
+        t0 = chrono::steady_clock::now();
+        bool wide_match = staircaseMaxArea(wide) == fast;
+        t1 = chrono::steady_clock::now();
+        double wide_ms = chrono::duration<double, milli>(t1 - t0).count();
+
+        cout << "n=" << n << "  staircase: " << fast << " in " << fast_ms << " ms (int64: " << wide_ms
+             << " ms" << (wide_match ? "" : ", MISMATCH") << ")";
+        if (n <= 100000) {
+            t0 = chrono::steady_clock::now();
+            long long brute = bruteForceMaxArea(points);
+            t1 = chrono::steady_clock::now();
+            double brute_ms = chrono::duration<double, milli>(t1 - t0).count();
+            cout << "  pair loop: " << brute << " in " << brute_ms << " ms"
+                 << (brute == fast ? "  (match)" : "  (MISMATCH)");
+        } else {
+            cout << "  pair loop: skipped";
         }
-        points.emplace_back(x, y);
+        cout << endl;
+    }
+}
+
+// Plain vs tiled pair loop on the first `rows` rows of large random point
+// sets (about 5e8 pairs each), with hardware cache-miss counts.
+void runTilingBenchmark() {
+    PerfCounter l1d = PerfCounter::l1dMisses();
+    PerfCounter llc = PerfCounter::cacheMisses();
+    if (!l1d.available() || !llc.available())
+        cout << "perf_event_open unavailable, miss counts shown as -1" << endl;
+    cout << "tiles: " << DAY9_TILE_ROWS << " rows x " << DAY9_TILE_COLS << " cols" << endl;
+
+    mt19937 rng(2025);
+    uniform_int_distribution<int> coord(0, 100000);
+    for (size_t n : {100000, 1000000, 10000000}) {
+        vector<pair<int, int>> points(n);
+        for (auto& p : points) p = {coord(rng), coord(rng)};
+        size_t rows = max<size_t>(1, 500000000 / n);
+
+        auto measure = [&](const char* name, auto&& loop) {
+            l1d.start();
+            llc.start();
+            auto t0 = chrono::steady_clock::now();
+            long long area = loop();
+            auto t1 = chrono::steady_clock::now();
+            l1d.stop();
+            llc.stop();
+            cout << "n=" << n << " rows=" << rows << "  " << name << ": " << area << " in "
+                 << chrono::duration<double, milli>(t1 - t0).count() << " ms, L1d misses " << l1d.read()
+                 << ", cache misses " << llc.read() << endl;
+        };
+        measure("plain", [&] { return bruteForceMaxArea(points, rows); });
+        measure("tiled", [&] { return tiledMaxArea(points, rows); });
     }
+}
+
+template <typename Coord>
+string solve(const PointBuffer& buffer, const string& mode) {
+    vector<Pt<Coord>> points(buffer.size());
+    for (size_t k = 0; k < buffer.size(); ++k) points[k] = {(Coord)buffer.xs[k], (Coord)buffer.ys[k]};
+    return areaToString(mode == "--brute" ? tiledMaxArea(points) : staircaseMaxArea(points));
+}
 
-    size_t n = points.size();
-    long long max_area = 0;
-    for (size_t i = 0; i < n; ++i) {
-        for (size_t j = i + 1; j < n; ++j) {
-            int dx = abs(points[i].first - points[j].first);
-            int dy = abs(points[i].second - points[j].second);
-            long long area = (dx + 1LL) * (dy + 1);
-            if (area > max_area) {
-                max_area = area;
-            }
+int main(int argc, char* argv[]) {
+    string mode, filename = "input.txt";
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        if (arg == "--brute" || arg == "--bench" || arg == "--bench-tiles") {
+            mode = arg;
+        } else if (arg.rfind("--", 0) == 0) {
+            cerr << "Usage: " << argv[0] << " [--brute | --bench | --bench-tiles] [FILE]" << endl;
+            return 1;
+        } else {
+            filename = arg;
         }
     }
+    if (mode == "--bench") {
+        runBenchmark();
+        return 0;
+    }
+    if (mode == "--bench-tiles") {
+        runTilingBenchmark();
+        return 0;
+    }
 
-    cout << max_area << endl;
+    PointBuffer buffer;
+    ParseStats stats;
+    if (!parsePointFile(filename, buffer, &stats)) return 1;
+    reportParse(stats, buffer.size());
+    if (!fitsCoordRange(buffer.xs, buffer.ys)) {
+        cerr << "Error: coordinates must lie within +-2^62" << endl;
+        return 1;
+    }
+
+    // Narrow coordinates take the dense int32 layout; anything wider is kept
+    // as int64 with 128-bit areas.
+    if (fitsInt32(buffer.xs, buffer.ys)) {
+        cout << solve<int32_t>(buffer, mode) << endl;
+    } else {
+        cout << solve<int64_t>(buffer, mode) << endl;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -1,169 +1,537 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <sstream>
-#include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <cstdio>
 
-using namespace std;
-
-struct Point {
-    long long x, y;
-};
+#include <unistd.h>
 
-struct VEdge {
-    long long x;
-    long long y_min, y_max;
-};
+#include "compressed_grid.h"
+#include "coord_width.h"
+#include "edge_scan.h"
+#include "edge_simd.h"
+#include "incremental_solver.h"
+#include "point_parser.h"
+#include "polygon_index.h"
+#include "staircase.h"
+#include "work_stealing.h"
 
-struct HEdge {
-    long long y;
-    long long x_min, x_max;
-};
+using namespace std;
 
 // Parse input handling x,y or space separated formats
-vector<Point> parseInput(const string& filename) {
-    vector<Point> points;
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cerr << "Error: Could not open " << filename << endl;
+PointBuffer parseInput(const string& filename) {
+    PointBuffer buffer;
+    ParseStats stats;
+    if (!parsePointFile(filename, buffer, &stats)) exit(1);
+    reportParse(stats, buffer.size());
+    if (!fitsCoordRange(buffer.xs, buffer.ys)) {
+        cerr << "Error: coordinates must lie within +-2^62" << endl;
         exit(1);
     }
+    return buffer;
+}
 
-    string line;
-    while (getline(file, line)) {
-        // Replace commas with spaces
-        for (char &c : line) if (c == ',') c = ' ';
-        
-        stringstream ss(line);
-        long long x, y;
-        while (ss >> x >> y) {
-            points.push_back({x, y});
-        }
-    }
+template <typename PointT>
+vector<PointT> toPoints(const PointBuffer& buffer) {
+    vector<PointT> points(buffer.size());
+    for (size_t k = 0; k < buffer.size(); ++k)
+        points[k] = {(decltype(PointT::x))buffer.xs[k], (decltype(PointT::y))buffer.ys[k]};
     return points;
 }
 
-int main() {
-    // 1. Load Data
-    vector<Point> points = parseInput("input.txt");
-    int n = points.size();
-    
-    if (n < 4) {
-        cout << "Not enough points to form a polygon." << endl;
-        return 0;
-    }
+// A pair of red tiles and the rectangle they span. The search runs over
+// int32 or int64 tiles (see coord_width.h); the engines take long long.
+template <typename Coord>
+struct Candidate {
+    int i, j;
+    Coord left, bottom, right, top;
+    AreaOf<Coord> area;
+};
+
+template <typename Coord>
+Candidate<Coord> makeCandidate(const vector<BasicPoint<Coord>>& tiles, int i, int j) {
+    Coord x1 = tiles[i].x;
+    Coord y1 = tiles[i].y;
+    Coord x2 = tiles[j].x;
+    Coord y2 = tiles[j].y;
 
-    // 2. Build Polygon Edges
-    vector<VEdge> v_edges;
-    vector<HEdge> h_edges;
+    // Form a rectangle (even if width/height is 0, it's 1 tile wide/tall)
+    AreaOf<Coord> width = (AreaOf<Coord>)max(x1, x2) - min(x1, x2);
+    AreaOf<Coord> height = (AreaOf<Coord>)max(y1, y2) - min(y1, y2);
+
+    // CORRECTION: Inclusive Area Calculation (Grid Tiles)
+    AreaOf<Coord> area = (width + 1) * (height + 1);
+
+    return {i, j, min(x1, x2), min(y1, y2), max(x1, x2), max(y1, y2), area};
+}
+
+// Iterate all pairs of red tiles, validating only those that would improve
+// the best area found so far. isValid(const Candidate&) is any containment test.
+template <typename Coord, typename Validator>
+AreaOf<Coord> findMaxArea(const vector<BasicPoint<Coord>>& tiles, const Validator& isValid) {
+    int n = tiles.size();
+    AreaOf<Coord> max_area = 0;
 
     for (int i = 0; i < n; ++i) {
-        Point p1 = points[i];
-        Point p2 = points[(i + 1) % n];
+        for (int j = i + 1; j < n; ++j) {
+            Candidate<Coord> c = makeCandidate(tiles, i, j);
+            if (c.area <= max_area) continue;
 
-        if (p1.x == p2.x) {
-            v_edges.push_back({p1.x, min(p1.y, p2.y), max(p1.y, p2.y)});
-        } else if (p1.y == p2.y) {
-            h_edges.push_back({p1.y, min(p1.x, p2.x), max(p1.x, p2.x)});
+            if (isValid(c)) {
+                max_area = c.area;
+            }
         }
     }
+    return max_area;
+}
 
-    // 3. Sort edges for Binary Search
-    sort(v_edges.begin(), v_edges.end(), [](const VEdge& a, const VEdge& b) {
-        return a.x < b.x;
-    });
-    sort(h_edges.begin(), h_edges.end(), [](const HEdge& a, const HEdge& b) {
-        return a.y < b.y;
+// Same search as findMaxArea with each row i as a task on a work-stealing
+// pool. All threads prune against the shared best, which only ever holds the
+// area of a validated rectangle, so the result is the same for any thread count.
+template <typename Coord, typename Validator>
+AreaOf<Coord> findMaxAreaParallel(const vector<BasicPoint<Coord>>& tiles, const Validator& isValid, int threads) {
+    int n = tiles.size();
+    SharedMax<AreaOf<Coord>> best;
+
+    struct Counters {
+        long long pairs = 0;
+        long long checks = 0;
+    };
+    vector<Counters> counters(max(threads, 1));
+
+    vector<WorkerStats> stats = runWorkStealing(n, threads, [&](int i, int worker) {
+        long long pairs = 0, checks = 0;
+        for (int j = i + 1; j < n; ++j) {
+            Candidate<Coord> c = makeCandidate(tiles, i, j);
+            ++pairs;
+            if (best.prunes(c.area)) continue;
+            ++checks;
+            if (isValid(c)) best.raise(c.area);
+        }
+        counters[worker].pairs += pairs;
+        counters[worker].checks += checks;
     });
 
-    long long max_area = 0;
+    for (size_t w = 0; w < stats.size(); ++w) {
+        cerr << "Thread " << w << ": " << stats[w].tasks_run << " rows ("
+             << stats[w].tasks_stolen << " stolen), " << counters[w].pairs << " pairs, "
+             << counters[w].checks << " checks, " << stats[w].busy_ms << " ms" << endl;
+    }
+    return best.get();
+}
 
-    // 4. Iterate all pairs of Red Tiles
-    for (int i = 0; i < n; ++i) {
+// Visit candidates in descending area order and pass the first `k` valid
+// ones to emit(const Candidate&) as they are found, largest first.
+// The global heap holds one entry per row i. It is seeded with partnerBounds
+// from staircase.h, row i's largest area over every partner, in O(n log n)
+// plus the staircase runs rather than an O(n^2) scan. A row's partners are
+// only materialized into their own heap when its bound first reaches the
+// top, and then only those whose own row is not materialized yet, so each
+// pair lives in exactly one row. The row goes back in keyed by its exact
+// largest remaining area. Rows whose bound never reaches the top cost no
+// pair arithmetic and no memory; their pairs are reached from the other end.
+template <typename Coord, typename Validator, typename Emit>
+AreaOf<Coord> findTopOrdered(const vector<BasicPoint<Coord>>& tiles, const Validator& isValid, int k,
+                             const Emit& emit) {
+    int n = tiles.size();
+    using Entry = pair<AreaOf<Coord>, int>; // (area, partner or row)
+
+    vector<Pt<Coord>> pts(n);
+    for (int i = 0; i < n; ++i) pts[i] = {tiles[i].x, tiles[i].y};
+    vector<AreaOf<Coord>> bound = partnerBounds(pts);
+    priority_queue<Entry> rows;
+    for (int i = 0; i < n; ++i) rows.push({bound[i], i});
+
+    vector<vector<Entry>> partners(n);
+    vector<bool> materialized(n, false);
+    long long examined = 0, rows_materialized = 0;
+    AreaOf<Coord> result = 0;
+    int found = 0;
+
+    while (!rows.empty() && found < k) {
+        int i = rows.top().second;
+        rows.pop();
+
+        vector<Entry>& heap = partners[i];
+        if (!materialized[i]) {
+            materialized[i] = true;
+            rows_materialized++;
+            for (int j = 0; j < n; ++j)
+                if (!materialized[j]) heap.push_back({makeCandidate(tiles, i, j).area, j});
+            make_heap(heap.begin(), heap.end());
+            if (!heap.empty()) rows.push({heap.front().first, i});
+            continue;
+        }
+
+        pop_heap(heap.begin(), heap.end());
+        int j = heap.back().second;
+        heap.pop_back();
+
+        examined++;
+        Candidate<Coord> c = makeCandidate(tiles, min(i, j), max(i, j));
+        if (isValid(c)) {
+            if (found++ == 0) result = c.area;
+            emit(c);
+        }
+
+        if (heap.empty()) {
+            vector<Entry>().swap(heap);
+        } else {
+            rows.push({heap.front().first, i});
+        }
+    }
+
+    cerr << "Ordered search examined " << examined << " candidates, materialized "
+         << rows_materialized << " of " << n << " rows" << endl;
+    return result;
+}
+
+template <typename Coord, typename Validator>
+AreaOf<Coord> findMaxAreaOrdered(const vector<BasicPoint<Coord>>& tiles, const Validator& isValid) {
+    return findTopOrdered(tiles, isValid, 1, [](const Candidate<Coord>&) {});
+}
+
+// K largest valid rectangles by the pair loop. A bounded min-heap holds the
+// best K so far, and once it is full its smallest area replaces max_area as
+// the pruning threshold. Rows run on the work-stealing pool; the heap is only
+// locked for candidates that passed validation.
+template <typename Coord, typename Validator>
+vector<Candidate<Coord>> findTopPairs(const vector<BasicPoint<Coord>>& tiles, const Validator& isValid, int k,
+                                      int threads) {
+    int n = tiles.size();
+    auto smaller = [](const Candidate<Coord>& a, const Candidate<Coord>& b) { return a.area > b.area; };
+    priority_queue<Candidate<Coord>, vector<Candidate<Coord>>, decltype(smaller)> top(smaller);
+    mutex mu;
+    SharedMax<AreaOf<Coord>> threshold;
+
+    runWorkStealing(n, threads, [&](int i, int) {
         for (int j = i + 1; j < n; ++j) {
-            long long x1 = points[i].x;
-            long long y1 = points[i].y;
-            long long x2 = points[j].x;
-            long long y2 = points[j].y;
-
-            // Form a rectangle (even if width/height is 0, it's 1 tile wide/tall)
-            long long width = abs(x1 - x2);
-            long long height = abs(y1 - y2);
-            
-            // CORRECTION: Inclusive Area Calculation (Grid Tiles)
-            long long area = (width + 1) * (height + 1);
-
-            if (area <= max_area) continue;
-
-            long long left = min(x1, x2);
-            long long right = max(x1, x2);
-            long long bottom = min(y1, y2);
-            long long top = max(y1, y2);
-
-            bool invalid = false;
-
-            // --- CHECK A: Vertical Edge Intersection ---
-            // Look for polygon edges strictly INSIDE the x-range (left, right)
-            auto it_v = upper_bound(v_edges.begin(), v_edges.end(), left, 
-                [](long long val, const VEdge& e) { return val < e.x; });
-            
-            for (; it_v != v_edges.end(); ++it_v) {
-                if (it_v->x >= right) break; 
-                // Check if this vertical edge cuts through the rectangle's Y range
-                // Intersection of (y_min, y_max) and (bottom, top)
-                // We use strict > bottom and < top to ensure we don't count touching boundaries
-                if (it_v->y_min < top && it_v->y_max > bottom) {
-                    invalid = true;
-                    break;
-                }
-            }
-            if (invalid) continue;
-
-            // --- CHECK B: Horizontal Edge Intersection ---
-            auto it_h = upper_bound(h_edges.begin(), h_edges.end(), bottom, 
-                [](long long val, const HEdge& e) { return val < e.y; });
-
-            for (; it_h != h_edges.end(); ++it_h) {
-                if (it_h->y >= top) break;
-                if (it_h->x_min < right && it_h->x_max > left) {
-                    invalid = true;
-                    break;
-                }
+            Candidate<Coord> c = makeCandidate(tiles, i, j);
+            if (threshold.prunes(c.area)) continue;
+            if (!isValid(c)) continue;
+            lock_guard<mutex> lock(mu);
+            top.push(c);
+            if ((int)top.size() > k) top.pop();
+            if ((int)top.size() == k) threshold.raise(top.top().area);
+        }
+    });
+
+    vector<Candidate<Coord>> result;
+    while (!top.empty()) {
+        result.push_back(top.top());
+        top.pop();
+    }
+    reverse(result.begin(), result.end());
+    return result;
+}
+
+template <typename Coord>
+void printRanked(const vector<BasicPoint<Coord>>& tiles, int rank, const Candidate<Coord>& c) {
+    cout << "#" << rank << " area " << areaToString(c.area) << ": (" << tiles[c.i].x << "," << tiles[c.i].y
+         << ") - (" << tiles[c.j].x << "," << tiles[c.j].y << ")" << endl;
+}
+
+// Runs the chosen search. With top > 0 the K largest rectangles are printed
+// as ranked lines; the ordered search (the default for --top) streams each
+// one as soon as it is found, while the pairs search can only print them
+// once every row is done.
+template <typename Coord, typename Validator>
+AreaOf<Coord> runSearch(const vector<BasicPoint<Coord>>& tiles, const Validator& isValid, const string& search,
+                        int threads, int top) {
+    auto start = chrono::steady_clock::now();
+    AreaOf<Coord> area;
+    if (top > 0 && search == "ordered") {
+        int rank = 0;
+        area = findTopOrdered(tiles, isValid, top, [&](const Candidate<Coord>& c) {
+            printRanked(tiles, ++rank, c);
+        });
+    } else if (top > 0) {
+        vector<Candidate<Coord>> best = findTopPairs(tiles, isValid, top, threads);
+        for (size_t r = 0; r < best.size(); ++r) printRanked(tiles, r + 1, best[r]);
+        area = best.empty() ? 0 : best[0].area;
+    } else if (search == "ordered") {
+        area = findMaxAreaOrdered(tiles, isValid);
+    } else if (threads > 1) {
+        area = findMaxAreaParallel(tiles, isValid, threads);
+    } else {
+        area = findMaxArea(tiles, isValid);
+    }
+    // The ordered search is single-threaded whatever --threads says
+    if (search == "pairs" && threads > 1) {
+        cerr << "Search wall time: "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count()
+             << " ms on " << threads << " threads" << endl;
+    }
+    return area;
+}
+
+// Answers "x1,y1,x2,y2" rectangle queries from stdin, one "valid AREA" or
+// "invalid AREA" line per query, until EOF. Input is read in whatever chunks
+// the pipe delivers and each chunk's answers are flushed together, so a
+// caller can send a batch and wait for exactly that many lines. Malformed
+// queries, and those with a coordinate outside +-2^62, are reported on
+// stderr and answered with "error" to keep lines aligned. Latency is the time spent answering, not waiting for input.
+template <typename RectValidator>
+void runServer(const RectValidator& isValid) {
+    vector<char> buffer(1 << 20);
+    string pending, out;
+    long long queries = 0, batches = 0;
+    double busy_us = 0;
+
+    while (true) {
+        ssize_t got = read(STDIN_FILENO, buffer.data(), buffer.size());
+        if (got <= 0) break;
+        auto start = chrono::steady_clock::now();
+        pending.append(buffer.data(), got);
+
+        size_t line_start = 0, nl;
+        while ((nl = pending.find('\n', line_start)) != string::npos) {
+            const char* p = pending.data() + line_start;
+            const char* end = pending.data() + nl;
+            if (end > p && end[-1] == '\r') --end;
+            line_start = nl + 1;
+            if (end == p) continue;
+
+            long long q[4];
+            if (!parseIntegerLine(p, end, q, 4) || !all_of(q, q + 4, inCoordRange)) {
+                cerr << "Invalid line: " << string(p, end) << endl;
+                out += "error\n";
+                continue;
             }
-            if (invalid) continue;
-
-            // --- CHECK C: Enclosure (Point in Polygon) ---
-            // Ray Casting from the center-bottom of the rectangle.
-            // Conceptual Ray Origin: x = left + epsilon, y = bottom + 0.5
-            // Actually, since we proved no edges are *inside* (left, right),
-            // we can cast a ray from anywhere in that X range.
-            // We check how many vertical edges are to the RIGHT (x >= right).
-            
-            // We need to count edges that cover the Y-slice [bottom, bottom+1]
-            // i.e., edge.y_min <= bottom AND edge.y_max > bottom
-            
-            // Start searching for edges at x >= right (boundary is included in ray check)
-            auto it_ray = lower_bound(v_edges.begin(), v_edges.end(), right, 
-                [](const VEdge& e, long long val) { return e.x < val; });
-             
-             long long intersections = 0;
-             for (; it_ray != v_edges.end(); ++it_ray) {
-                 // Does this edge cross the line y = bottom + 0.5?
-                 if (it_ray->y_min <= bottom && it_ray->y_max > bottom) {
-                     intersections++;
-                 }
-             }
-
-             // Odd intersections = Inside
-             if (intersections % 2 != 0) {
-                 max_area = area;
-             }
+            long long left = min(q[0], q[2]), right = max(q[0], q[2]);
+            long long bottom = min(q[1], q[3]), top = max(q[1], q[3]);
+            __int128 area = ((__int128)right - left + 1) * ((__int128)top - bottom + 1);
+            out += isValid(left, bottom, right, top) ? "valid " : "invalid ";
+            out += areaToString(area);
+            out += '\n';
+            queries++;
         }
+        pending.erase(0, line_start);
+
+        if (!out.empty()) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            fflush(stdout);
+            out.clear();
+            batches++;
+        }
+        busy_us += chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
     }
 
-    cout << "Part 2 Largest Area: " << max_area << endl;
+    cerr << "Served " << queries << " queries in " << batches << " batches, "
+         << (queries ? busy_us / queries : 0) << " us/query amortized" << endl;
+}
+
+// Moves a random vertical edge of the polygon by up to +-100 columns, `edits`
+// times. A move the solver rejects (it would leave a diagonal edge) is
+// counted but neither timed nor compared. After each applied move, IncrementalSolver::query() is timed against a full
+// recompute: rebuilding the edge lists and rerunning the single-threaded
+// scan pair search. Both must give the same area. Coord picks the area
+// type, as in solve().
+template <typename Coord>
+int runEdits(const vector<Point>& points, int edits) {
+    IncrementalSolver<Coord> solver(points);
+    solver.query();
+    int n = solver.size();
+    int vertical_parity = points[0].x == points[1].x ? 0 : 1;
+    mt19937 rng(1);
+    uniform_int_distribution<int> edge(0, n / 2 - 1);
+    uniform_int_distribution<long long> shift(-100, 100);
+
+    double incremental_ms = 0, full_ms = 0;
+    long long rechecked = 0, mismatches = 0;
+    int applied = 0;
+    for (int e = 0; e < edits; ++e) {
+        int k = 2 * edge(rng) + vertical_parity;
+        if (!solver.moveVerticalEdge(k, solver.vertexAt(k).x + shift(rng))) continue;
+        applied++;
+
+        auto t0 = chrono::steady_clock::now();
+        AreaOf<Coord> incremental = solver.query();
+        auto t1 = chrono::steady_clock::now();
+        vector<Point> current = solver.points();
+        EdgeLists edges = buildEdges(current);
+        vector<BasicPoint<int64_t>> tiles;
+        for (const Point& p : current) tiles.push_back({p.x, p.y});
+        AreaOf<int64_t> full = findMaxArea(tiles, [&](const auto& c) {
+            return isRectangleValidScan(edges, c.left, c.bottom, c.right, c.top);
+        });
+        auto t2 = chrono::steady_clock::now();
+
+        incremental_ms += chrono::duration<double, milli>(t1 - t0).count();
+        full_ms += chrono::duration<double, milli>(t2 - t1).count();
+        rechecked += solver.lastRechecked();
+        if (incremental != full) {
+            cerr << "Edit " << e << ": incremental gives " << areaToString(incremental) << ", full search "
+                 << areaToString(full) << endl;
+            mismatches++;
+        }
+    }
+
+    cout << "Part 2 Largest Area after " << applied << " edits: " << areaToString(solver.query()) << endl;
+    int timed = max(applied, 1);
+    cerr << "Applied " << applied << " of " << edits << " edits" << endl;
+    cerr << "Incremental: " << incremental_ms / timed << " ms/query (" << rechecked / timed
+         << " checks), full search: " << full_ms / timed << " ms, " << mismatches << " mismatches" << endl;
+    return mismatches ? 1 : 0;
+}
+
+struct Options {
+    string engine = "scan";
+    string search; // pairs, or ordered when --top is given
+    string kernel;
+    int threads = 1;
+    int top = 0;
+};
+
+// Runs the search with Coord-wide tiles; the engines always see long long.
+template <typename Coord>
+int solve(const PointBuffer& buffer, const vector<Point>& points, const Options& opt) {
+    vector<BasicPoint<Coord>> tiles = toPoints<BasicPoint<Coord>>(buffer);
+    cerr << "Coordinates: " << CoordTraits<Coord>::name << endl;
+
+    AreaOf<Coord> max_area = 0;
+    if (opt.engine == "scan") {
+        EdgeLists edges = buildEdges(points);
+        max_area = runSearch(tiles, [&](const auto& c) {
+            return isRectangleValidScan(edges, c.left, c.bottom, c.right, c.top);
+        }, opt.search, opt.threads, opt.top);
+    } else if (opt.engine == "index") {
+        PolygonIndex index(points);
+        max_area = runSearch(tiles, [&](const auto& c) {
+            return index.isRectangleValid(c.left, c.bottom, c.right, c.top);
+        }, opt.search, opt.threads, opt.top);
+    } else if (opt.engine == "grid") {
+        CompressedGrid grid(points);
+        cerr << "Compressed grid: " << grid.width() << "x" << grid.height() << " cells, "
+             << grid.memoryBytes() << " bytes resident (+" << grid.rasterBytes()
+             << " bytes transient raster)" << endl;
+        max_area = runSearch(tiles, [&](const auto& c) {
+            return grid.isPairValid(c.i, c.j);
+        }, opt.search, opt.threads, opt.top);
+    } else if (opt.engine == "simd") {
+        EdgeSoAPair soa = toSoA(buildEdges(points));
+        withEdgeKernel(opt.kernel, [&](auto kernel) {
+            using Kernel = decltype(kernel);
+            cerr << "Edge kernel: " << Kernel::name << endl;
+            max_area = runSearch(tiles, [&](const auto& c) {
+                return Kernel::isRectangleValid(soa, c.left, c.bottom, c.right, c.top);
+            }, opt.search, opt.threads, opt.top);
+        });
+    } else {
+        cerr << "Unknown engine: " << opt.engine << endl;
+        return 1;
+    }
 
+    if (opt.top == 0) cout << "Part 2 Largest Area: " << areaToString(max_area) << endl;
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char* argv[]) {
+    // --engine scan   linear walk over the sorted edge lists (default)
+    // --engine index  merge-sort tree index, O(log^2 n) per rectangle
+    // --engine grid   compressed prefix-sum grid, O(1) per rectangle
+    // --engine simd   scan over SoA edges with AVX-512/AVX2/scalar batches
+    // --kernel NAME   force the simd kernel (avx512, avx2, scalar)
+    // --threads N     split the pair loop over N work-stealing threads
+    // --search ordered  visit pairs by descending area, stop at the first valid
+    // --top K         print the K largest valid rectangles as they are found, via the
+    //                 ordered search; with --search pairs they print only once all pairs are done
+    // --serve         load the polygon once, then answer x1,y1,x2,y2 queries from stdin
+    // --edits N       move N random vertical edges, timing incremental queries against full searches
+    // --input FILE    read red tiles from FILE instead of input.txt
+    Options opt;
+    string input = "input.txt";
+    bool serve = false;
+    int edits = 0;
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        if (arg == "--engine" && a + 1 < argc) {
+            opt.engine = argv[++a];
+        } else if (arg == "--kernel" && a + 1 < argc) {
+            opt.kernel = argv[++a];
+        } else if (arg == "--search" && a + 1 < argc) {
+            opt.search = argv[++a];
+        } else if (arg == "--threads" && a + 1 < argc) {
+            opt.threads = max(1, atoi(argv[++a]));
+        } else if (arg == "--serve") {
+            serve = true;
+        } else if (arg == "--top" && a + 1 < argc) {
+            opt.top = max(1, atoi(argv[++a]));
+        } else if (arg == "--edits" && a + 1 < argc) {
+            edits = max(1, atoi(argv[++a]));
+        } else if (arg == "--input" && a + 1 < argc) {
+            input = argv[++a];
+        } else {
+            cerr << "Usage: " << argv[0] << " [--engine scan|index|grid|simd] [--kernel NAME] [--threads N] [--search pairs|ordered] [--top K] [--serve] [--edits N] [--input FILE]" << endl;
+            cerr << "  --top K streams results via the ordered search; with --search pairs they print only at the end" << endl;
+            return 1;
+        }
+    }
+
+    if (opt.search.empty()) opt.search = opt.top > 0 ? "ordered" : "pairs";
+    if (opt.search != "pairs" && opt.search != "ordered") {
+        cerr << "Unknown search: " << opt.search << endl;
+        return 1;
+    }
+    if (opt.engine != "scan" && opt.engine != "index" && opt.engine != "grid" && opt.engine != "simd") {
+        cerr << "Unknown engine: " << opt.engine << endl;
+        return 1;
+    }
+
+    // 1. Load Data
+    PointBuffer buffer = parseInput(input);
+    vector<Point> points = toPoints<Point>(buffer);
+    int n = points.size();
+
+    if (n < 4) {
+        cout << "Not enough points to form a polygon." << endl;
+        return 0;
+    }
+
+    if (edits > 0) {
+        if (fitsInt32(buffer.xs, buffer.ys)) return runEdits<int32_t>(points, edits);
+        return runEdits<int64_t>(points, edits);
+    }
+
+    if (serve) {
+        auto start = chrono::steady_clock::now();
+        if (opt.engine == "index") {
+            PolygonIndex index(points);
+            runServer([&](long long l, long long b, long long r, long long t) {
+                return index.isRectangleValid(l, b, r, t);
+            });
+        } else if (opt.engine == "grid") {
+            CompressedGrid grid(points);
+            runServer([&](long long l, long long b, long long r, long long t) {
+                return grid.isRectangleValid(l, b, r, t);
+            });
+        } else if (opt.engine == "simd") {
+            EdgeSoAPair soa = toSoA(buildEdges(points));
+            withEdgeKernel(opt.kernel, [&](auto kernel) {
+                using Kernel = decltype(kernel);
+                runServer([&](long long l, long long b, long long r, long long t) {
+                    return Kernel::isRectangleValid(soa, l, b, r, t);
+                });
+            });
+        } else {
+            EdgeLists edges = buildEdges(points);
+            runServer([&](long long l, long long b, long long r, long long t) {
+                return isRectangleValidScan(edges, l, b, r, t);
+            });
+        }
+        cerr << "Session time: "
+             << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms" << endl;
+        return 0;
+    }
+
+    // 2. Narrow coordinates search over the dense int32 layout, anything wider
+    // over int64 tiles with 128-bit areas
+    if (fitsInt32(buffer.xs, buffer.ys)) return solve<int32_t>(buffer, points, opt);
+    return solve<int64_t>(buffer, points, opt);
+}
@@ -0,0 +1,189 @@
+#ifndef DAY9_STAIRCASE_H
+#define DAY9_STAIRCASE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "coord_width.h"
+
+// Everything below is instantiated for int32_t and int64_t coordinates (see
+// coord_width.h); differences are taken in the area type, so they cannot
+// overflow the coordinate type.
+template <typename Coord> using Pt = std::pair<Coord, Coord>;
+
+#ifndef DAY9_TILE_ROWS
+#define DAY9_TILE_ROWS 256
+#endif
+#ifndef DAY9_TILE_COLS
+#define DAY9_TILE_COLS 4096
+#endif
+
+template <typename Coord>
+AreaOf<Coord> pairArea(const Pt<Coord>& a, const Pt<Coord>& b) {
+    using Area = AreaOf<Coord>;
+    Area dx = (Area)a.first - b.first;
+    Area dy = (Area)a.second - b.second;
+    return ((dx < 0 ? -dx : dx) + 1) * ((dy < 0 ? -dy : dy) + 1);
+}
+
+// Reference answer: try every pair. O(n^2). With rows < n only pairs whose
+// first index is below rows are tried (benchmarks on huge inputs).
+template <typename Coord>
+AreaOf<Coord> bruteForceMaxArea(const std::vector<Pt<Coord>>& points, size_t rows = SIZE_MAX) {
+    size_t n = points.size();
+    rows = std::min(rows, n);
+    AreaOf<Coord> max_area = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            AreaOf<Coord> area = pairArea(points[i], points[j]);
+            if (area > max_area) {
+                max_area = area;
+            }
+        }
+    }
+    return max_area;
+}
+
+// Same pairs as bruteForceMaxArea, visited in tiles. A block of BlockRows
+// rows is swept over one chunk of BlockCols columns at a time, so each chunk
+// is streamed from memory once per row block instead of once per row. The
+// default column chunk is 32 KiB of int32 points, sized for L1d; override
+// with -DDAY9_TILE_ROWS=... -DDAY9_TILE_COLS=...
+template <size_t BlockRows = DAY9_TILE_ROWS, size_t BlockCols = DAY9_TILE_COLS, typename Coord>
+AreaOf<Coord> tiledMaxArea(const std::vector<Pt<Coord>>& points, size_t rows = SIZE_MAX) {
+    static_assert(BlockRows > 0 && BlockCols > 0, "tile sizes must be positive");
+    size_t n = points.size();
+    rows = std::min(rows, n);
+    AreaOf<Coord> max_area = 0;
+    for (size_t ib = 0; ib < rows; ib += BlockRows) {
+        size_t ie = std::min(ib + BlockRows, rows);
+        for (size_t jb = ib + 1; jb < n; jb += BlockCols) {
+            size_t je = std::min(jb + BlockCols, n);
+            for (size_t i = ib; i < ie; ++i) {
+                for (size_t j = std::max(jb, i + 1); j < je; ++j) {
+                    AreaOf<Coord> area = pairArea(points[i], points[j]);
+                    if (area > max_area) {
+                        max_area = area;
+                    }
+                }
+            }
+        }
+    }
+    return max_area;
+}
+
+// Points with no other point both left-of-or-equal and below-or-equal.
+// Returned sorted by x ascending, which makes y strictly descending.
+template <typename Coord>
+std::vector<Pt<Coord>> lowerStaircase(std::vector<Pt<Coord>> pts) {
+    std::sort(pts.begin(), pts.end());
+    std::vector<Pt<Coord>> stair;
+    for (const Pt<Coord>& p : pts) {
+        if (stair.empty() || p.second < stair.back().second) {
+            stair.push_back(p);
+        }
+    }
+    return stair;
+}
+
+// Points with no other point both right-of-or-equal and above-or-equal.
+// Also returned x ascending / y strictly descending.
+template <typename Coord>
+std::vector<Pt<Coord>> upperStaircase(std::vector<Pt<Coord>> pts) {
+    std::sort(pts.begin(), pts.end(), std::greater<Pt<Coord>>());
+    std::vector<Pt<Coord>> stair;
+    for (const Pt<Coord>& p : pts) {
+        if (stair.empty() || p.second > stair.back().second) {
+            stair.push_back(p);
+        }
+    }
+    std::reverse(stair.begin(), stair.end());
+    return stair;
+}
+
+// Inclusive area of the rectangle with lower-left lo and upper-right hi.
+// A pair that is not ordered that way scores <= 0, so it never wins; a lower
+// staircase point can never be strictly dominated by an upper one, so the
+// "both deltas negative" case that would wrongly score positive cannot occur.
+template <typename Coord>
+AreaOf<Coord> cornerArea(const Pt<Coord>& lo, const Pt<Coord>& hi) {
+    using Area = AreaOf<Coord>;
+    return ((Area)hi.first - lo.first + 1) * ((Area)hi.second - lo.second + 1);
+}
+
+// For lower[i] the best partner index in upper is non-decreasing in i, so the
+// row maxima can be found by divide and conquer in O((|L| + |U|) log |L|).
+template <typename Coord>
+void bestPartners(const std::vector<Pt<Coord>>& lower, const std::vector<Pt<Coord>>& upper,
+                  int lo, int hi, int opt_lo, int opt_hi, AreaOf<Coord>& best) {
+    if (lo > hi) return;
+    int mid = (lo + hi) / 2;
+    AreaOf<Coord> mid_best = cornerArea(lower[mid], upper[opt_lo]);
+    int mid_opt = opt_lo;
+    for (int j = opt_lo + 1; j <= opt_hi; ++j) {
+        AreaOf<Coord> area = cornerArea(lower[mid], upper[j]);
+        if (area > mid_best) {
+            mid_best = area;
+            mid_opt = j;
+        }
+    }
+    best = std::max(best, mid_best);
+    bestPartners(lower, upper, lo, mid - 1, opt_lo, mid_opt, best);
+    bestPartners(lower, upper, mid + 1, hi, mid_opt, opt_hi, best);
+}
+
+template <typename Coord>
+AreaOf<Coord> diagonalMaxArea(const std::vector<Pt<Coord>>& pts) {
+    std::vector<Pt<Coord>> lower = lowerStaircase(pts);
+    std::vector<Pt<Coord>> upper = upperStaircase(pts);
+    AreaOf<Coord> best = 0;
+    bestPartners(lower, upper, 0, (int)lower.size() - 1, 0, (int)upper.size() - 1, best);
+    return best;
+}
+
+// Staircase engine. Any optimal pair is either lower-left/upper-right or
+// upper-left/lower-right; mirroring y turns the second case into the first.
+// The mirror is ~y = -y - 1, which keeps every span and is defined for every
+// coordinate, unlike -y on the minimum.
+// Both corners can always be pushed out to the matching staircase without
+// shrinking the rectangle, so only staircase points need to be paired.
+template <typename Coord>
+AreaOf<Coord> staircaseMaxArea(const std::vector<Pt<Coord>>& points) {
+    if (points.size() < 2) return 0;
+    std::vector<Pt<Coord>> pts(points);
+    AreaOf<Coord> best = diagonalMaxArea(pts);
+    for (Pt<Coord>& p : pts) p.second = ~p.second;
+    return std::max(best, diagonalMaxArea(pts));
+}
+
+// Largest area each point makes with any point, itself included. The best
+// partner of p lies in one of its four quadrants and can be pushed out to
+// that quadrant's staircase, so for each mirroring only the upper staircase
+// points that dominate p are scored; they form one contiguous run. Costs
+// O(n log n) plus the run lengths, at most O(n * staircase size).
+template <typename Coord>
+std::vector<AreaOf<Coord>> partnerBounds(const std::vector<Pt<Coord>>& points) {
+    std::vector<AreaOf<Coord>> bound(points.size(), 0);
+    for (int mirror = 0; mirror < 4; ++mirror) {
+        std::vector<Pt<Coord>> pts(points);
+        for (Pt<Coord>& p : pts) {
+            if (mirror & 1) p.first = ~p.first;
+            if (mirror & 2) p.second = ~p.second;
+        }
+        std::vector<Pt<Coord>> upper = upperStaircase(pts);
+        for (size_t k = 0; k < pts.size(); ++k) {
+            const Pt<Coord>& p = pts[k];
+            auto first = std::lower_bound(upper.begin(), upper.end(), p.first,
+                [](const Pt<Coord>& s, Coord x) { return s.first < x; });
+            auto last = std::partition_point(first, upper.end(),
+                [&](const Pt<Coord>& s) { return s.second >= p.second; });
+            for (auto it = first; it != last; ++it) bound[k] = std::max(bound[k], cornerArea(p, *it));
+        }
+    }
+    return bound;
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef DAY9_WORK_STEALING_H
+#define DAY9_WORK_STEALING_H
+
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Per-worker counters collected by runWorkStealing.
+struct WorkerStats {
+    long long tasks_run = 0;
+    long long tasks_stolen = 0;
+    double busy_ms = 0;
+};
+
+// Runs task(t, worker) for every t in [0, num_tasks) on `threads` workers.
+// Tasks are dealt round-robin into per-worker deques; a worker pops from the
+// back of its own deque and, once empty, steals from the front of the others.
+// Task order is not deterministic, so `task` must only combine results in an
+// order-independent way (max, sum, ...).
+template <typename Task>
+std::vector<WorkerStats> runWorkStealing(int num_tasks, int threads, const Task& task) {
+    if (threads < 1) threads = 1;
+
+    struct Queue {
+        std::mutex mu;
+        std::deque<int> tasks;
+    };
+    std::vector<Queue> queues(threads);
+    for (int t = 0; t < num_tasks; ++t) queues[t % threads].tasks.push_back(t);
+
+    std::vector<WorkerStats> stats(threads);
+    auto worker = [&](int self) {
+        auto start = std::chrono::steady_clock::now();
+        while (true) {
+            int t = -1;
+            {
+                std::lock_guard<std::mutex> lock(queues[self].mu);
+                if (!queues[self].tasks.empty()) {
+                    t = queues[self].tasks.back();
+                    queues[self].tasks.pop_back();
+                }
+            }
+            for (int k = 1; t < 0 && k < threads; ++k) {
+                Queue& victim = queues[(self + k) % threads];
+                std::lock_guard<std::mutex> lock(victim.mu);
+                if (!victim.tasks.empty()) {
+                    t = victim.tasks.front();
+                    victim.tasks.pop_front();
+                    stats[self].tasks_stolen++;
+                }
+            }
+            // Tasks never spawn tasks, so empty everywhere means done.
+            if (t < 0) break;
+            task(t, self);
+            stats[self].tasks_run++;
+        }
+        stats[self].busy_ms =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < threads; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (std::thread& th : pool) th.join();
+    return stats;
+}
+
+#endif